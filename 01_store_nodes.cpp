@@ -5,32 +5,33 @@
 #include <MetallNodeStorageBackend.hpp>
 
 
-int main() {
-    std::cout << "Hello, World!" << std::endl;
-
-    std::string storage_path{"/tmp/metall_test"};
-
-    metall::manager storage_manager{metall::create_only, storage_path.c_str()};
+int main(int argc, char *argv[]) {
+    std::string storage_path{argc > 1 ? argv[1] : "/tmp/metall_test"};
     std::cout << storage_path.c_str() <<'\n';
 
     using namespace rdf4cpp::rdf::storage::node;
 
-    auto *nodestore_backend = storage_manager.find_or_construct<metall_node_storage::MetallNodeStorageBackend>("node_store")(storage_manager.get_allocator());
+    {
+        metall::manager storage_manager{metall::create_only, storage_path.c_str()};
 
-    NodeStorage node_storage = NodeStorage::register_backend(nodestore_backend);
-    NodeStorage::default_instance(node_storage);
+        // NodeStorage does not own the backend, it is released after unregistering
+        auto *nodestore_backend = new metall_node_storage::MetallNodeStorageBackend(storage_manager);
 
-    using namespace rdf4cpp::rdf;
+        NodeStorage node_storage = NodeStorage::register_backend(nodestore_backend);
+        NodeStorage::default_instance(node_storage);
 
-    Literal l{"Some random Literal"};
-    using namespace rdf4cpp::rdf::storage::node::view;
-    node_storage.find_or_make_id(LiteralBackendView());
+        using namespace rdf4cpp::rdf;
 
-    IRI i{"https://example.com/asdkjeredasdsadsadsadagergfd"};
+        Literal l{"Some random Literal"};
+        using namespace rdf4cpp::rdf::storage::node::view;
+        node_storage.find_or_make_id(LiteralBackendView());
 
-    NodeStorage::unregister_backend(nodestore_backend);
-    std::cout << storage_path.c_str() <<'\n';
+        IRI i{"https://example.com/asdkjeredasdsadsadsadagergfd"};
 
-    exit(0);
+        NodeStorage::unregister_backend(nodestore_backend);
+        // the datastore is closed consistently when storage_manager goes out of scope
+    }
+    std::cout << storage_path.c_str() <<'\n';
 
+    return 0;
 }
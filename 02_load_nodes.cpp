@@ -1,23 +1,44 @@
+#include <chrono>
 #include <iostream>
 #include <metall/metall.hpp>
 #include <rdf4cpp/rdf.hpp>
 
 #include <MetallNodeStorageBackend.hpp>
-int main() {
-    std::cout << "Hello, World!" << std::endl;
+int main(int argc, char *argv[]) {
+    std::string storage_path{argc > 1 ? argv[1] : "/tmp/metall_test"};
 
-    std::string storage_path{"/tmp/metall_test"};
+    if (!metall::manager::consistent(storage_path.c_str())) {
+        std::cerr << storage_path << " is not a consistent Metall datastore. Run 01_store_nodes first." << std::endl;
+        return 1;
+    }
 
-    metall::manager storage_manager{metall::create_only, storage_path.c_str()};
+    auto const start = std::chrono::steady_clock::now();
+
+    metall::manager storage_manager{metall::open_read_only, storage_path.c_str()};
 
     using namespace rdf4cpp::rdf::storage::node;
 
-    auto *nodestore_backend = storage_manager.find_or_construct<metall_node_storage::MetallNodeStorageBackend>("node_store")(storage_manager.get_allocator());
+    // attaches to the node store written by 01_store_nodes, nothing is rebuilt
+    auto *nodestore_backend = new metall_node_storage::MetallNodeStorageBackend(
+            storage_manager, {.access_pattern = metall_node_storage::AccessPattern::random});
 
     NodeStorage node_storage = NodeStorage::register_backend(nodestore_backend);
     NodeStorage::default_instance(node_storage);
 
+    auto const ready = std::chrono::steady_clock::now();
+    std::cout << "Opened " << storage_path << " in "
+              << std::chrono::duration<double, std::milli>(ready - start).count() << " ms" << std::endl;
+
+    // lookups are served while the datastore is read into memory in the background
+    auto warm_up = nodestore_backend->warm_up();
+
     using namespace rdf4cpp::rdf;
 
+    warm_up->wait();
+    std::cout << "Loaded " << warm_up->bytes_loaded() / (1024 * 1024) << " MiB in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - ready).count() << " ms" << std::endl;
+    warm_up.reset();
+
+    NodeStorage::unregister_backend(nodestore_backend);
     return 0;
 }
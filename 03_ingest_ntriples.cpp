@@ -0,0 +1,470 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <metall/metall.hpp>
+#include <rdf4cpp/rdf.hpp>
+#include <serd/serd.h>
+
+#include <MetallNodeStorageBackend.hpp>
+
+namespace {
+
+using namespace rdf4cpp::rdf::storage::node;
+using metall_node_storage::MetallNodeStorageBackend;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Multi-producer/multi-consumer queue with a fixed capacity.
+ * push blocks while the queue is full, so a fast producer is throttled to the speed of the consumers.
+ */
+template<typename T>
+class BoundedQueue {
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::queue<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push(std::move(item));
+        not_empty_.notify_one();
+    }
+
+    /**
+     * @return the next item, or std::nullopt once the queue is closed and drained
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty())
+            return std::nullopt;
+        T item = std::move(items_.front());
+        items_.pop();
+        not_full_.notify_one();
+        return item;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+};
+
+/**
+ * Counters shared by all stages. Times are the summed busy time of the threads of a stage, without waiting on queues.
+ */
+struct Stats {
+    std::atomic<uint64_t> bytes_read = 0;
+    std::atomic<uint64_t> triples = 0;
+    std::atomic<uint64_t> terms = 0;
+    std::atomic<uint64_t> errors = 0;
+    /**
+     * Literals that were not interned because their datatype IRI could not be expanded.
+     */
+    std::atomic<uint64_t> skipped_literals = 0;
+    std::atomic<uint64_t> read_ns = 0;
+    std::atomic<uint64_t> parse_ns = 0;
+    std::atomic<uint64_t> intern_ns = 0;
+};
+
+uint64_t elapsed_ns(Clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+}
+
+/**
+ * Terms collected from a piece of the input.
+ * Serd lends node buffers only for the duration of a callback, so the terms are copied into bytes.
+ */
+struct TermBatch {
+    struct Span {
+        size_t offset = 0;
+        size_t length = 0;
+    };
+    struct PendingLiteral {
+        Span lexical;
+        Span language_tag;
+        /**
+         * Index into iris, or no_datatype for plain literals.
+         */
+        size_t datatype;
+    };
+    static constexpr size_t no_datatype = static_cast<size_t>(-1);
+
+    std::string bytes;
+    std::vector<Span> iris;
+    std::vector<Span> bnodes;
+    std::vector<PendingLiteral> literals;
+    uint64_t triples = 0;
+
+    [[nodiscard]] std::string_view view(Span span) const noexcept {
+        return std::string_view{bytes}.substr(span.offset, span.length);
+    }
+
+    Span copy(uint8_t const *buf, size_t n_bytes) {
+        Span span{.offset = bytes.size(), .length = n_bytes};
+        bytes.append(reinterpret_cast<char const *>(buf), n_bytes);
+        return span;
+    }
+};
+
+/**
+ * Parser state handed to serd as callback handle.
+ */
+struct ParseContext {
+    TermBatch batch;
+    SerdEnv *env = nullptr;
+    Stats *stats = nullptr;
+    /**
+     * Full batches are pushed here. Not set for the chunked N-Triples path, where a batch is one chunk.
+     */
+    BoundedQueue<TermBatch> *batch_queue = nullptr;
+    size_t max_batch_bytes = 0;
+};
+
+/**
+ * Copies an IRI into the batch. Prefixed names and relative IRIs are expanded when the syntax has an environment (Turtle).
+ * @return index into batch.iris, or TermBatch::no_datatype if the IRI cannot be expanded. That is counted as an error.
+ */
+size_t add_iri(ParseContext &ctx, SerdNode const *node) {
+    if (ctx.env == nullptr) {
+        ctx.batch.iris.push_back(ctx.batch.copy(node->buf, node->n_bytes));
+        return ctx.batch.iris.size() - 1;
+    }
+    SerdNode expanded = serd_env_expand_node(ctx.env, node);
+    if (expanded.buf == nullptr) {
+        ++ctx.stats->errors;
+        return TermBatch::no_datatype;
+    }
+    ctx.batch.iris.push_back(ctx.batch.copy(expanded.buf, expanded.n_bytes));
+    serd_node_free(&expanded);
+    return ctx.batch.iris.size() - 1;
+}
+
+void add_node(ParseContext &ctx, SerdNode const *node, SerdNode const *datatype, SerdNode const *lang) {
+    switch (node->type) {
+        case SERD_URI:
+        case SERD_CURIE:
+            add_iri(ctx, node);
+            break;
+        case SERD_BLANK:
+            ctx.batch.bnodes.push_back(ctx.batch.copy(node->buf, node->n_bytes));
+            break;
+        case SERD_LITERAL: {
+            TermBatch::PendingLiteral literal{.lexical = ctx.batch.copy(node->buf, node->n_bytes),
+                                              .language_tag = {},
+                                              .datatype = TermBatch::no_datatype};
+            if (lang != nullptr) {
+                literal.language_tag = ctx.batch.copy(lang->buf, lang->n_bytes);
+            } else if (datatype != nullptr) {
+                literal.datatype = add_iri(ctx, datatype);
+                // interning it as a plain literal would change its value
+                if (literal.datatype == TermBatch::no_datatype) {
+                    ++ctx.stats->skipped_literals;
+                    break;
+                }
+            }
+            ctx.batch.literals.push_back(literal);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+SerdStatus on_statement(void *handle, [[maybe_unused]] SerdStatementFlags flags, SerdNode const *graph,
+                        SerdNode const *subject, SerdNode const *predicate, SerdNode const *object,
+                        SerdNode const *object_datatype, SerdNode const *object_lang) {
+    auto &ctx = *static_cast<ParseContext *>(handle);
+    add_node(ctx, subject, nullptr, nullptr);
+    add_node(ctx, predicate, nullptr, nullptr);
+    add_node(ctx, object, object_datatype, object_lang);
+    // N-Quads and TriG name the graph of a statement
+    if (graph != nullptr)
+        add_node(ctx, graph, nullptr, nullptr);
+    ++ctx.batch.triples;
+
+    if (ctx.batch_queue != nullptr && ctx.batch.bytes.size() >= ctx.max_batch_bytes) {
+        ctx.batch_queue->push(std::move(ctx.batch));
+        ctx.batch = TermBatch{};
+    }
+    return SERD_SUCCESS;
+}
+
+SerdStatus on_base(void *handle, SerdNode const *uri) {
+    auto &ctx = *static_cast<ParseContext *>(handle);
+    return ctx.env != nullptr ? serd_env_set_base_uri(ctx.env, uri) : SERD_SUCCESS;
+}
+
+SerdStatus on_prefix(void *handle, SerdNode const *name, SerdNode const *uri) {
+    auto &ctx = *static_cast<ParseContext *>(handle);
+    return ctx.env != nullptr ? serd_env_set_prefix(ctx.env, name, uri) : SERD_SUCCESS;
+}
+
+SerdStatus on_error(void *handle, [[maybe_unused]] SerdError const *error) {
+    ++static_cast<Stats *>(handle)->errors;
+    return SERD_SUCCESS;
+}
+
+/**
+ * Interns all terms of a batch, one bulk call per node type.
+ */
+void intern(MetallNodeStorageBackend &backend, TermBatch const &batch, Stats &stats) {
+    auto const start = Clock::now();
+
+    std::vector<view::IRIBackendView> iris;
+    iris.reserve(batch.iris.size());
+    for (auto const &span : batch.iris)
+        iris.push_back({.identifier = batch.view(span)});
+    auto const iri_ids = backend.find_or_make_ids(std::span<view::IRIBackendView const>{iris});
+
+    std::vector<view::BNodeBackendView> bnodes;
+    bnodes.reserve(batch.bnodes.size());
+    for (auto const &span : batch.bnodes)
+        bnodes.push_back({.identifier = batch.view(span)});
+    [[maybe_unused]] auto const bnode_ids = backend.find_or_make_ids(std::span<view::BNodeBackendView const>{bnodes});
+
+    // literals last, their datatype IRIs have IDs now
+    std::vector<view::LiteralBackendView> literals;
+    literals.reserve(batch.literals.size());
+    for (auto const &literal : batch.literals) {
+        identifier::NodeID datatype_id;
+        if (literal.language_tag.length != 0)
+            datatype_id = identifier::NodeID::rdf_langstring_iri.first;
+        else if (literal.datatype != TermBatch::no_datatype)
+            datatype_id = iri_ids[literal.datatype];
+        else
+            datatype_id = identifier::NodeID::xsd_string_iri.first;
+        literals.push_back({.datatype_id = datatype_id,
+                            .lexical_form = batch.view(literal.lexical),
+                            .language_tag = batch.view(literal.language_tag)});
+    }
+    [[maybe_unused]] auto const literal_ids = backend.find_or_make_ids(std::span<view::LiteralBackendView const>{literals});
+
+    stats.terms += iris.size() + bnodes.size() + literals.size();
+    stats.triples += batch.triples;
+    stats.intern_ns += elapsed_ns(start);
+}
+
+/**
+ * N-Triples and N-Quads have one statement per line, so the input can be cut at line ends and parsed in parallel.
+ * One thread reads newline-aligned chunks of at least chunk_size bytes, or up to the end of a longer line,
+ * the workers parse and intern them.
+ */
+void ingest_line_based(std::filesystem::path const &input, SerdSyntax syntax, MetallNodeStorageBackend &backend,
+                       size_t n_workers, size_t chunk_size, Stats &stats) {
+    BoundedQueue<std::string> chunks{2 * n_workers};
+
+    std::thread reader{[&] {
+        std::ifstream in{input, std::ios::binary};
+        std::string carry;
+        while (in) {
+            auto const start = Clock::now();
+            std::string chunk = std::move(carry);
+            size_t const filled = chunk.size();
+            chunk.resize(filled + chunk_size);
+            in.read(chunk.data() + filled, static_cast<std::streamsize>(chunk_size));
+            chunk.resize(filled + static_cast<size_t>(in.gcount()));
+            stats.bytes_read += static_cast<uint64_t>(in.gcount());
+
+            // keep the incomplete last line for the next chunk. A line longer than a chunk is carried whole
+            // until its end has been read, it must not be split across workers.
+            carry.clear();
+            if (in) {
+                size_t const last_newline = chunk.rfind('\n');
+                if (last_newline == std::string::npos) {
+                    carry = std::move(chunk);
+                    chunk.clear();
+                } else {
+                    carry.assign(chunk, last_newline + 1);
+                    chunk.resize(last_newline + 1);
+                }
+            }
+            stats.read_ns += elapsed_ns(start);
+            if (!chunk.empty())
+                chunks.push(std::move(chunk));
+        }
+        if (!carry.empty())
+            chunks.push(std::move(carry));
+        chunks.close();
+    }};
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < n_workers; ++i) {
+        workers.emplace_back([&] {
+            ParseContext ctx{.batch = {}, .stats = &stats};
+            SerdReader *serd_reader = serd_reader_new(syntax, &ctx, nullptr, on_base, on_prefix, on_statement, nullptr);
+            serd_reader_set_error_sink(serd_reader, on_error, &stats);
+
+            while (auto chunk = chunks.pop()) {
+                auto const start = Clock::now();
+                ctx.batch = TermBatch{};
+                serd_reader_read_string(serd_reader, reinterpret_cast<uint8_t const *>(chunk->c_str()));
+                stats.parse_ns += elapsed_ns(start);
+
+                intern(backend, ctx.batch, stats);
+            }
+            serd_reader_free(serd_reader);
+        });
+    }
+
+    reader.join();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+/**
+ * Input of the Turtle parser. The bytes are counted as serd reads them, so that the progress line advances.
+ */
+struct CountingSource {
+    FILE *file;
+    Stats *stats;
+};
+
+/**
+ * Bytes serd requests per read, the page size it uses for files itself.
+ */
+constexpr size_t turtle_page_size = 4096;
+
+size_t read_counting(void *buffer, size_t size, size_t count, void *stream) {
+    auto &source = *static_cast<CountingSource *>(stream);
+    size_t const read = std::fread(buffer, size, count, source.file);
+    source.stats->bytes_read += read * size;
+    return read;
+}
+
+int counting_error(void *stream) {
+    return std::ferror(static_cast<CountingSource *>(stream)->file);
+}
+
+/**
+ * Turtle statements can span lines and depend on earlier prefix declarations, so it is parsed by a single thread.
+ * The parser hands batches of terms to the workers, which intern them.
+ */
+void ingest_turtle(std::filesystem::path const &input, MetallNodeStorageBackend &backend,
+                   size_t n_workers, size_t batch_size, Stats &stats) {
+    BoundedQueue<TermBatch> batches{2 * n_workers};
+
+    std::thread parser{[&] {
+        auto const start = Clock::now();
+        ParseContext ctx{.batch = {}, .env = serd_env_new(nullptr), .stats = &stats, .batch_queue = &batches, .max_batch_bytes = batch_size};
+        SerdReader *serd_reader = serd_reader_new(SERD_TURTLE, &ctx, nullptr, on_base, on_prefix, on_statement, nullptr);
+        serd_reader_set_error_sink(serd_reader, on_error, &stats);
+
+        if (FILE *file = std::fopen(input.c_str(), "rb"); file != nullptr) {
+            CountingSource source{.file = file, .stats = &stats};
+            serd_reader_read_source(serd_reader, read_counting, counting_error, &source,
+                                    reinterpret_cast<uint8_t const *>(input.c_str()), turtle_page_size);
+            std::fclose(file);
+        } else {
+            ++stats.errors;
+        }
+        if (ctx.batch.triples != 0)
+            batches.push(std::move(ctx.batch));
+
+        serd_reader_free(serd_reader);
+        serd_env_free(ctx.env);
+        batches.close();
+        // reading and parsing are interleaved inside serd and cannot be timed separately
+        stats.parse_ns += elapsed_ns(start);
+    }};
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < n_workers; ++i) {
+        workers.emplace_back([&] {
+            while (auto batch = batches.pop())
+                intern(backend, *batch, stats);
+        });
+    }
+
+    parser.join();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void print_rate(std::string_view stage, double amount, std::string_view unit, uint64_t busy_ns, double wall_s) {
+    double const busy_s = static_cast<double>(busy_ns) / 1e9;
+    std::cout << std::left << std::setw(8) << stage << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << (wall_s > 0 ? amount / wall_s : 0.0) << ' ' << unit << " (wall)"
+              << std::setw(12) << (busy_s > 0 ? amount / busy_s : 0.0) << ' ' << unit << " per busy thread"
+              << std::setw(10) << busy_s << " s busy" << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <file.nt|file.nq|file.ttl> [datastore_path] [threads]" << std::endl;
+        return 1;
+    }
+    std::filesystem::path const input{argv[1]};
+    std::string const storage_path{argc > 2 ? argv[2] : "/tmp/metall_test"};
+    size_t const n_workers = argc > 3 ? std::stoul(argv[3]) : std::max(1U, std::thread::hardware_concurrency());
+
+    constexpr size_t chunk_size = size_t{8} << 20;
+
+    Stats stats;
+    auto const start = Clock::now();
+    {
+        metall::manager storage_manager{metall::create_only, storage_path.c_str()};
+        // the arenas are written front to back during the load
+        MetallNodeStorageBackend backend{storage_manager, {.access_pattern = metall_node_storage::AccessPattern::sequential}};
+
+        std::mutex progress_mutex;
+        std::condition_variable progress_cv;
+        bool done = false;
+        std::thread progress{[&] {
+            std::unique_lock<std::mutex> lock{progress_mutex};
+            while (!progress_cv.wait_for(lock, std::chrono::seconds{5}, [&] { return done; })) {
+                double const wall_s = static_cast<double>(elapsed_ns(start)) / 1e9;
+                std::cerr << std::fixed << std::setprecision(1) << wall_s << " s: "
+                          << static_cast<double>(stats.bytes_read) / (1 << 20) << " MiB read, "
+                          << stats.triples << " triples, " << stats.terms << " terms" << std::endl;
+            }
+        }};
+
+        auto const extension = input.extension();
+        if (extension == ".ttl")
+            ingest_turtle(input, backend, n_workers, chunk_size, stats);
+        else
+            ingest_line_based(input, extension == ".nq" ? SERD_NQUADS : SERD_NTRIPLES, backend, n_workers, chunk_size, stats);
+
+        {
+            std::lock_guard<std::mutex> lock{progress_mutex};
+            done = true;
+        }
+        progress_cv.notify_one();
+        progress.join();
+    }
+    double const wall_s = static_cast<double>(elapsed_ns(start)) / 1e9;
+
+    double const mib = static_cast<double>(stats.bytes_read) / (1 << 20);
+    std::cout << input.string() << " -> " << storage_path << " with " << n_workers << " workers in "
+              << std::fixed << std::setprecision(2) << wall_s << " s\n"
+              << stats.triples << " triples, " << stats.terms << " terms, " << stats.errors << " parse errors\n";
+    if (stats.skipped_literals != 0)
+        std::cout << stats.skipped_literals << " literals skipped, their datatype IRI could not be expanded\n";
+    print_rate("read", mib, "MiB/s", stats.read_ns, wall_s);
+    print_rate("parse", static_cast<double>(stats.triples), "triples/s", stats.parse_ns, wall_s);
+    print_rate("intern", static_cast<double>(stats.terms), "terms/s", stats.intern_ns, wall_s);
+    return stats.errors == 0 ? 0 : 2;
+}
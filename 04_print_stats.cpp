@@ -0,0 +1,40 @@
+#include <iomanip>
+#include <iostream>
+#include <metall/metall.hpp>
+
+#include <MetallNodeStorageBackend.hpp>
+
+using namespace rdf4cpp::rdf::storage::node::metall_node_storage;
+
+static void print_node_type(char const *name, NodeTypeStats const &stats) {
+    constexpr double mib = 1024.0 * 1024.0;
+    std::cout << name << '\n'
+              << "  nodes                 " << stats.count << " (" << stats.erased << " erased)\n"
+              << "  strings               " << stats.string_bytes / mib << " MiB, avg length " << stats.average_string_length << '\n'
+              << "  reverse index         " << stats.index_bytes / mib << " MiB, load factor " << stats.index_load_factor
+              << " (fullest stripe " << stats.max_stripe_load_factor << ")\n"
+              << "  forward table         " << stats.forward_bytes_used / mib << " of " << stats.forward_bytes_reserved / mib << " MiB used\n"
+              << "  string arena          " << stats.arena_bytes_used / mib << " of " << stats.arena_bytes_reserved / mib << " MiB used\n";
+}
+
+int main(int argc, char *argv[]) {
+    std::string storage_path{argc > 1 ? argv[1] : "/tmp/metall_test"};
+
+    if (!metall::manager::consistent(storage_path.c_str())) {
+        std::cerr << storage_path << " is not a consistent Metall datastore. Run 01_store_nodes first." << std::endl;
+        return 1;
+    }
+
+    metall::manager storage_manager{metall::open_read_only, storage_path.c_str()};
+    MetallNodeStorageBackend backend{storage_manager};
+
+    StorageStats const stats = backend.stats();
+    std::cout << std::fixed << std::setprecision(2);
+    print_node_type("iri", stats.iri);
+    std::cout << "  shared prefixes       " << stats.iri_prefixes << '\n';
+    print_node_type("literal", stats.literal);
+    std::cout << "  language tags         " << stats.language_tags << '\n';
+    print_node_type("bnode", stats.bnode);
+    print_node_type("variable", stats.variable);
+    return 0;
+}
\ No newline at end of file
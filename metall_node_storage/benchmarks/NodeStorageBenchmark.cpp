@@ -0,0 +1,498 @@
+/**
+ * Benchmarks of MetallNodeStorageBackend (and InMemoryNodeStorageBackend and FrozenNodeStorageBackend for comparison) on the synthetic workloads in Workloads.hpp.
+ * Results are written as JSON for comparing releases, e.g.
+ *   metall_node_storage_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+ * or through the run_metall_node_storage_benchmarks target. The datastores are created below the temp directory.
+ */
+#include <benchmark/benchmark.h>
+#include <metall/metall.hpp>
+
+#include <FrozenNodeStorageBackend.hpp>
+#include <MetallNodeStorageBackend.hpp>
+
+#include "Workloads.hpp"
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace rdf4cpp::rdf::storage::node;
+using namespace rdf4cpp::rdf::storage::node::metall_node_storage;
+using namespace rdf4cpp::rdf::storage::node::metall_node_storage::benchmarks;
+
+static std::filesystem::path datastore_path(std::string const &name) {
+    return std::filesystem::temp_directory_path() / ("metall_node_storage_benchmark_" + name);
+}
+
+/**
+ * A backend on a fresh datastore. The datastore is removed first if it is left over from an earlier run.
+ */
+struct FreshStore {
+    std::filesystem::path path;
+    std::unique_ptr<metall::manager> manager;
+    std::unique_ptr<MetallNodeStorageBackend> backend;
+
+    explicit FreshStore(std::string const &name) : path(datastore_path(name)) {
+        std::filesystem::remove_all(path);
+        manager = std::make_unique<metall::manager>(metall::create_only, path.c_str());
+        backend = std::make_unique<MetallNodeStorageBackend>(*manager);
+    }
+
+    ~FreshStore() {
+        backend.reset();
+        manager.reset();
+        std::filesystem::remove_all(path);
+    }
+};
+
+static view::LiteralBackendView literal_view(LiteralTerm const &literal, identifier::NodeID integer_id) {
+    identifier::NodeID const datatype = literal.integer                ? integer_id
+                                        : literal.language_tag.empty() ? identifier::NodeID::xsd_string_iri.first
+                                                                       : identifier::NodeID::rdf_langstring_iri.first;
+    return {.datatype_id = datatype, .lexical_form = literal.lexical_form, .language_tag = literal.language_tag};
+}
+
+static identifier::NodeID xsd_integer_id(MetallNodeStorageBackend &backend) {
+    return backend.find_id(view::IRIBackendView{.identifier = "http://www.w3.org/2001/XMLSchema#integer"});
+}
+
+/**
+ * Sets the per-term memory counters of a node type from the store's stats.
+ */
+static void report_bytes_per_term(benchmark::State &state, NodeTypeStats const &stats) {
+    if (stats.count == 0)
+        return;
+    auto const count = static_cast<double>(stats.count);
+    state.counters["bytes_per_term"] = static_cast<double>(stats.arena_bytes_used + stats.forward_bytes_used + stats.index_bytes) / count;
+    state.counters["string_bytes_per_term"] = static_cast<double>(stats.string_bytes) / count;
+}
+
+/**
+ * All terms of a workload, stored once and shared by the lookup benchmarks of all threads.
+ */
+struct PopulatedStore : FreshStore {
+    std::vector<std::string> iris;
+    std::vector<identifier::NodeID> iri_ids;
+    std::vector<LiteralTerm> literals;
+    std::vector<identifier::NodeID> literal_ids;
+    identifier::NodeID integer_id;
+    std::vector<uint32_t> order;
+
+    explicit PopulatedStore(Workload workload)
+        : FreshStore(std::string{"populated_"} + workload_names[static_cast<size_t>(workload)]),
+          iris(make_iris(workload)),
+          literals(make_literals()),
+          integer_id(xsd_integer_id(*backend)),
+          order(make_access_order(workload, term_count)) {
+        for (auto const &iri : iris)
+            iri_ids.push_back(backend->find_or_make_id(view::IRIBackendView{.identifier = iri}));
+        for (auto const &literal : literals)
+            literal_ids.push_back(backend->find_or_make_id(literal_view(literal, integer_id)));
+    }
+
+    /**
+     * Position in order at which a thread starts, so that threads do not walk in lockstep.
+     */
+    [[nodiscard]] size_t start_of(benchmark::State const &state) const noexcept {
+        return state.thread_index() * (order.size() / state.threads());
+    }
+};
+
+static PopulatedStore &populated(Workload workload) {
+    static std::mutex mutex;
+    static std::array<std::unique_ptr<PopulatedStore>, workload_names.size()> stores;
+    std::lock_guard<std::mutex> lock{mutex};
+    auto &store = stores[static_cast<size_t>(workload)];
+    if (store == nullptr)
+        store = std::make_unique<PopulatedStore>(workload);
+    return *store;
+}
+
+static Workload workload_of(benchmark::State const &state) {
+    return static_cast<Workload>(state.range(0));
+}
+
+static void set_label(benchmark::State &state) {
+    state.SetLabel(workload_names[state.range(0)]);
+}
+
+static void BM_insert_iris(benchmark::State &state) {
+    std::vector<std::string> const iris = make_iris(workload_of(state));
+    FreshStore store{"insert_iris"};
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.backend->find_or_make_id(view::IRIBackendView{.identifier = iris[i++ % iris.size()]}));
+    state.SetItemsProcessed(state.iterations());
+    report_bytes_per_term(state, store.backend->stats().iri);
+    set_label(state);
+}
+
+static void BM_insert_literals(benchmark::State &state) {
+    std::vector<LiteralTerm> const literals = make_literals();
+    FreshStore store{"insert_literals"};
+    identifier::NodeID const integer_id = xsd_integer_id(*store.backend);
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.backend->find_or_make_id(literal_view(literals[i++ % literals.size()], integer_id)));
+    state.SetItemsProcessed(state.iterations());
+    report_bytes_per_term(state, store.backend->stats().literal);
+}
+
+static void BM_find_id_iri(benchmark::State &state) {
+    PopulatedStore &store = populated(workload_of(state));
+    size_t i = store.start_of(state);
+    for (auto _ : state) {
+        auto const &iri = store.iris[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend->find_id(view::IRIBackendView{.identifier = iri}));
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_or_make_id_iri(benchmark::State &state) {
+    PopulatedStore &store = populated(workload_of(state));
+    size_t i = store.start_of(state);
+    for (auto _ : state) {
+        auto const &iri = store.iris[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend->find_or_make_id(view::IRIBackendView{.identifier = iri}));
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_id_literal(benchmark::State &state) {
+    PopulatedStore &store = populated(workload_of(state));
+    size_t i = store.start_of(state);
+    for (auto _ : state) {
+        auto const &literal = store.literals[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend->find_id(literal_view(literal, store.integer_id)));
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_iri_backend_view(benchmark::State &state) {
+    PopulatedStore &store = populated(workload_of(state));
+    size_t i = store.start_of(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.backend->find_iri_backend_view(store.iri_ids[store.order[i++ % store.order.size()]]));
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_literal_backend_view(benchmark::State &state) {
+    PopulatedStore &store = populated(workload_of(state));
+    size_t i = store.start_of(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.backend->find_literal_backend_view(store.literal_ids[store.order[i++ % store.order.size()]]));
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+/**
+ * Asks the kernel to drop the cached pages of all files below path, so that the next open reads from disk.
+ */
+static void drop_page_cache(std::filesystem::path const &path) {
+    for (auto const &entry : std::filesystem::recursive_directory_iterator(path)) {
+        if (!entry.is_regular_file())
+            continue;
+        int const fd = ::open(entry.path().c_str(), O_RDONLY);
+        if (fd < 0)
+            continue;
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+/**
+ * Opening a closed datastore with cold page cache, attaching a backend and serving a first lookup.
+ */
+static void BM_cold_reopen(benchmark::State &state) {
+    std::filesystem::path const path = datastore_path("reopen");
+    std::filesystem::remove_all(path);
+    std::vector<std::string> const iris = make_iris(Workload::uniform);
+    {
+        metall::manager manager{metall::create_only, path.c_str()};
+        MetallNodeStorageBackend backend{manager};
+        std::vector<view::IRIBackendView> views;
+        for (auto const &iri : iris)
+            views.push_back({.identifier = iri});
+        benchmark::DoNotOptimize(backend.find_or_make_ids(std::span<view::IRIBackendView const>{views}));
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        drop_page_cache(path);
+        state.ResumeTiming();
+
+        metall::manager manager{metall::open_read_only, path.c_str()};
+        MetallNodeStorageBackend backend{manager};
+        benchmark::DoNotOptimize(backend.find_id(view::IRIBackendView{.identifier = iris.back()}));
+    }
+    std::filesystem::remove_all(path);
+}
+
+/**
+ * Counts the data TLB misses of the calling thread with perf_event_open.
+ * Not available without permission, e.g. with kernel.perf_event_paranoid > 2, or inside most VMs.
+ */
+class TlbMissCounter {
+    int fd_ = -1;
+
+public:
+    TlbMissCounter() noexcept {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~TlbMissCounter() {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    TlbMissCounter(TlbMissCounter const &) = delete;
+    TlbMissCounter &operator=(TlbMissCounter const &) = delete;
+
+    [[nodiscard]] bool available() const noexcept {
+        return fd_ >= 0;
+    }
+
+    void start() const noexcept {
+        ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    [[nodiscard]] uint64_t stop() const noexcept {
+        ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t misses = 0;
+        if (::read(fd_, &misses, sizeof(misses)) != sizeof(misses))
+            return 0;
+        return misses;
+    }
+};
+
+/**
+ * find_id on the uniform workload with the given HugePages setting, reporting data TLB misses per lookup.
+ * Huge pages only help if the kernel backs the mapping with them. For file-backed mappings that needs
+ * a recent kernel and filesystem support, otherwise both settings measure the same.
+ */
+static void BM_find_id_iri_huge_pages(benchmark::State &state) {
+    PopulatedStore &store = populated(Workload::uniform);
+    auto const huge_pages = static_cast<HugePages>(state.range(0));
+    if (!store.backend->advise(MappingOptions{.huge_pages = huge_pages, .access_pattern = AccessPattern::random}))
+        state.SetLabel("madvise rejected");
+
+    TlbMissCounter const tlb_misses;
+    if (tlb_misses.available())
+        tlb_misses.start();
+    size_t i = 0;
+    for (auto _ : state) {
+        auto const &iri = store.iris[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend->find_id(view::IRIBackendView{.identifier = iri}));
+    }
+    if (tlb_misses.available())
+        state.counters["dtlb_misses_per_lookup"] = static_cast<double>(tlb_misses.stop()) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * The uniform IRIs in an InMemoryNodeStorageBackend, to compare against BM_find_id_iri without offset_ptr.
+ */
+struct InMemoryStore {
+    HeapManager manager;
+    InMemoryNodeStorageBackend backend{manager};
+    std::vector<std::string> iris = make_iris(Workload::uniform);
+    std::vector<identifier::NodeID> iri_ids;
+    std::vector<uint32_t> order = make_access_order(Workload::uniform, term_count);
+
+    InMemoryStore() {
+        for (auto const &iri : iris)
+            iri_ids.push_back(backend.find_or_make_id(view::IRIBackendView{.identifier = iri}));
+    }
+};
+
+static InMemoryStore &in_memory() {
+    static InMemoryStore store;
+    return store;
+}
+
+static void BM_find_id_iri_in_memory(benchmark::State &state) {
+    InMemoryStore &store = in_memory();
+    size_t i = 0;
+    for (auto _ : state) {
+        auto const &iri = store.iris[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend.find_id(view::IRIBackendView{.identifier = iri}));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_find_iri_backend_view_in_memory(benchmark::State &state) {
+    InMemoryStore &store = in_memory();
+    size_t i = 0;
+    for (auto _ : state) {
+        auto const id = store.iri_ids[store.order[i++ % store.order.size()]];
+        benchmark::DoNotOptimize(store.backend.find_iri_backend_view(id));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * A populated store exported as a frozen image, read back through INodeStorageBackend like a caller that does not know
+ * the backend would. Strings that do not start a bucket are decoded on their first view and kept by the backend.
+ */
+struct FrozenStore {
+    PopulatedStore &source;
+    std::filesystem::path path;
+    std::unique_ptr<FrozenNodeStorageBackend> backend;
+
+    explicit FrozenStore(Workload workload)
+        : source(populated(workload)), path(datastore_path(std::string{"frozen_"} + workload_names[static_cast<size_t>(workload)])) {
+        std::filesystem::remove(path);
+        (void) source.backend->export_frozen_image(path.c_str());
+        backend = std::make_unique<FrozenNodeStorageBackend>(path.c_str());
+    }
+
+    ~FrozenStore() {
+        backend.reset();
+        std::filesystem::remove(path);
+    }
+
+    [[nodiscard]] INodeStorageBackend const &interface() const noexcept {
+        return *backend;
+    }
+};
+
+static FrozenStore &frozen(Workload workload) {
+    static std::mutex mutex;
+    static std::array<std::unique_ptr<FrozenStore>, workload_names.size()> stores;
+    std::lock_guard<std::mutex> lock{mutex};
+    auto &store = stores[static_cast<size_t>(workload)];
+    if (store == nullptr)
+        store = std::make_unique<FrozenStore>(workload);
+    return *store;
+}
+
+static void BM_find_id_iri_frozen(benchmark::State &state) {
+    FrozenStore &store = frozen(workload_of(state));
+    PopulatedStore const &source = store.source;
+    size_t i = source.start_of(state);
+    for (auto _ : state) {
+        auto const &iri = source.iris[source.order[i++ % source.order.size()]];
+        benchmark::DoNotOptimize(store.interface().find_id(view::IRIBackendView{.identifier = iri}));
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_iri_backend_view_frozen(benchmark::State &state) {
+    FrozenStore &store = frozen(workload_of(state));
+    PopulatedStore const &source = store.source;
+    size_t i = source.start_of(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.interface().find_iri_backend_view(source.iri_ids[source.order[i++ % source.order.size()]]));
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+static void BM_find_literal_backend_view_frozen(benchmark::State &state) {
+    FrozenStore &store = frozen(workload_of(state));
+    PopulatedStore const &source = store.source;
+    size_t i = source.start_of(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.interface().find_literal_backend_view(source.literal_ids[source.order[i++ % source.order.size()]]));
+    state.SetItemsProcessed(state.iterations());
+    set_label(state);
+}
+
+/**
+ * Checks that frozen serves every term of source under the same NodeID. The views are compared only after all of them
+ * were taken, so views that do not live as long as the backend show up as mismatches.
+ * @return number of terms that differ
+ */
+static size_t count_mismatches(PopulatedStore const &source, INodeStorageBackend const &frozen) {
+    size_t mismatches = 0;
+    std::vector<view::IRIBackendView> iri_views;
+    iri_views.reserve(source.iris.size());
+    for (size_t i = 0; i < source.iris.size(); ++i) {
+        mismatches += frozen.find_id(view::IRIBackendView{.identifier = source.iris[i]}) != source.iri_ids[i];
+        iri_views.push_back(frozen.find_iri_backend_view(source.iri_ids[i]));
+    }
+    std::vector<view::LiteralBackendView> literal_views;
+    literal_views.reserve(source.literals.size());
+    for (size_t i = 0; i < source.literals.size(); ++i) {
+        mismatches += frozen.find_id(literal_view(source.literals[i], source.integer_id)) != source.literal_ids[i];
+        literal_views.push_back(frozen.find_literal_backend_view(source.literal_ids[i]));
+    }
+    for (size_t i = 0; i < iri_views.size(); ++i)
+        mismatches += iri_views[i].identifier != source.iris[i];
+    for (size_t i = 0; i < literal_views.size(); ++i)
+        mismatches += literal_views[i] != literal_view(source.literals[i], source.integer_id);
+    return mismatches;
+}
+
+/**
+ * Exports a populated store as a frozen image and maps it. The round trip is checked outside of the timing,
+ * the benchmark fails if any term differs.
+ */
+static void BM_export_frozen_image(benchmark::State &state) {
+    PopulatedStore &source = populated(workload_of(state));
+    std::filesystem::path const path = datastore_path("export_frozen_image");
+    size_t mismatches = 0;
+    for (auto _ : state) {
+        std::filesystem::remove(path);
+        FrozenImageResult const result = source.backend->export_frozen_image(path.c_str());
+        FrozenNodeStorageBackend const frozen{path.c_str()};
+        state.PauseTiming();
+        mismatches += count_mismatches(source, frozen);
+        state.counters["image_bytes"] = static_cast<double>(result.image_bytes);
+        state.ResumeTiming();
+    }
+    std::filesystem::remove(path);
+    if (mismatches != 0)
+        state.SkipWithError("The frozen image differs from the store it was exported from.");
+    set_label(state);
+}
+
+static void workloads(benchmark::internal::Benchmark *benchmark) {
+    for (size_t workload = 0; workload < workload_names.size(); ++workload)
+        benchmark->Arg(static_cast<int64_t>(workload));
+}
+
+static void threaded_workloads(benchmark::internal::Benchmark *benchmark) {
+    workloads(benchmark);
+    benchmark->ThreadRange(1, 8)->UseRealTime();
+}
+
+BENCHMARK(BM_insert_iris)->Arg(static_cast<int64_t>(Workload::uniform))->Arg(static_cast<int64_t>(Workload::long_prefix))->Iterations(term_count)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_insert_literals)->Iterations(term_count)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_find_id_iri)->Apply(threaded_workloads);
+BENCHMARK(BM_find_or_make_id_iri)->Apply(threaded_workloads);
+BENCHMARK(BM_find_id_literal)->Apply(threaded_workloads);
+BENCHMARK(BM_find_iri_backend_view)->Apply(threaded_workloads);
+BENCHMARK(BM_find_literal_backend_view)->Apply(threaded_workloads);
+BENCHMARK(BM_find_id_iri_huge_pages)->Arg(static_cast<int64_t>(HugePages::disabled))->Arg(static_cast<int64_t>(HugePages::transparent));
+BENCHMARK(BM_find_id_iri_in_memory);
+BENCHMARK(BM_find_iri_backend_view_in_memory);
+BENCHMARK(BM_export_frozen_image)->Apply(workloads)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_find_id_iri_frozen)->Apply(threaded_workloads);
+BENCHMARK(BM_find_iri_backend_view_frozen)->Apply(threaded_workloads);
+BENCHMARK(BM_find_literal_backend_view_frozen)->Apply(threaded_workloads);
+BENCHMARK(BM_cold_reopen)->Unit(benchmark::kMillisecond)->Iterations(10);
+
+BENCHMARK_MAIN();
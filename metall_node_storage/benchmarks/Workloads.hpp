@@ -0,0 +1,107 @@
+#ifndef METALL_BENCHMARK_WORKLOADS_HPP
+#define METALL_BENCHMARK_WORKLOADS_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+#include <rdf4cpp/rdf/storage/node/view/IRIBackendView.hpp>
+#include <rdf4cpp/rdf/storage/node/view/LiteralBackendView.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage::benchmarks {
+
+/**
+ * Synthetic workloads: which terms are stored and in which order they are accessed.
+ */
+enum struct Workload {
+    /**
+     * Short IRIs in 64 namespaces, accessed uniformly.
+     */
+    uniform,
+    /**
+     * Same terms as uniform, accessed with a Zipfian skew like the subjects and objects of real datasets.
+     */
+    zipfian,
+    /**
+     * IRIs that share one 200-byte prefix, accessed uniformly.
+     */
+    long_prefix,
+};
+
+inline constexpr std::array<char const *, 3> workload_names{"uniform", "zipfian", "long_prefix"};
+
+/**
+ * Number of distinct terms of every workload.
+ */
+inline constexpr size_t term_count = size_t{1} << 20;
+
+inline std::vector<std::string> make_iris(Workload workload) {
+    std::string const long_prefix = "http://example.org/" + std::string(180, 'p') + "/resource/";
+    std::vector<std::string> iris;
+    iris.reserve(term_count);
+    for (size_t i = 0; i < term_count; ++i) {
+        if (workload == Workload::long_prefix)
+            iris.push_back(long_prefix + std::to_string(i));
+        else
+            iris.push_back("http://example.org/ns" + std::to_string(i % 64) + "/resource/" + std::to_string(i));
+    }
+    return iris;
+}
+
+/**
+ * Lexical forms and language tags of the literals. Most are plain strings, some language-tagged
+ * and some integers, which are inlined into their NodeID.
+ */
+struct LiteralTerm {
+    std::string lexical_form;
+    std::string_view language_tag;
+    bool integer;
+};
+
+inline std::vector<LiteralTerm> make_literals() {
+    constexpr std::array<std::string_view, 8> language_tags{"en", "de", "fr", "es", "it", "ja", "zh", "en-US"};
+    std::vector<LiteralTerm> literals;
+    literals.reserve(term_count);
+    for (size_t i = 0; i < term_count; ++i) {
+        if (i % 10 == 0)
+            literals.push_back({std::to_string(i), {}, true});
+        else if (i % 5 == 0)
+            literals.push_back({"label of resource " + std::to_string(i), language_tags[i % language_tags.size()], false});
+        else
+            literals.push_back({"literal value " + std::to_string(i), {}, false});
+    }
+    return literals;
+}
+
+/**
+ * Indices into the term list in the order in which a workload accesses them. Fixed seed, so runs are comparable.
+ */
+inline std::vector<uint32_t> make_access_order(Workload workload, size_t length) {
+    std::mt19937_64 random{42};
+    std::vector<uint32_t> order(length);
+    if (workload != Workload::zipfian) {
+        std::uniform_int_distribution<uint32_t> uniform{0, term_count - 1};
+        std::ranges::generate(order, [&]() { return uniform(random); });
+        return order;
+    }
+
+    // inverse transform sampling over the cumulative distribution, exponent 0.99
+    std::vector<double> cdf(term_count);
+    double sum = 0;
+    for (size_t rank = 0; rank < term_count; ++rank)
+        cdf[rank] = sum += 1.0 / std::pow(static_cast<double>(rank + 1), 0.99);
+    std::uniform_real_distribution<double> uniform{0, sum};
+    std::ranges::generate(order, [&]() {
+        return static_cast<uint32_t>(std::ranges::lower_bound(cdf, uniform(random)) - cdf.begin());
+    });
+    return order;
+}
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage::benchmarks
+#endif  //METALL_BENCHMARK_WORKLOADS_HPP
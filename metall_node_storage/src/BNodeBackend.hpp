@@ -1,41 +1,56 @@
 #ifndef METALL_BNODEBACKEND_HPP
 #define METALL_BNODEBACKEND_HPP
 
-#include <metall/metall.hpp>
-
 #include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
 #include <rdf4cpp/rdf/storage/node/view/BNodeBackendView.hpp>
 
+#include "StringArena.hpp"
+
 #include <compare>
-#include <memory>
 #include <string>
 #include <string_view>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
+/**
+ * Stored blank node. The identifier lives in a StringArena, the record only keeps its position.
+ */
 class BNodeBackend {
-    std::string identifier_;
+    StringRef identifier_;
 
 public:
-    explicit BNodeBackend(std::string_view identifier) noexcept;
-    explicit BNodeBackend(view::BNodeBackendView view) noexcept;
-    auto operator<=>(BNodeBackend const &) const noexcept = default;
-    auto operator<=>(view::BNodeBackendView const &other) const noexcept {
-        return view::BNodeBackendView(*this) <=> other;
+    BNodeBackend() noexcept = default;
+    template<StoragePolicy Policy>
+    BNodeBackend(StringArena<Policy> &arena, std::string_view identifier) : identifier_(arena.append(identifier)) {}
+    template<StoragePolicy Policy>
+    BNodeBackend(StringArena<Policy> &arena, view::BNodeBackendView view) : identifier_(arena.append(view.identifier)) {}
+
+    [[nodiscard]] bool null() const noexcept {
+        return identifier_.null();
     }
-    std::partial_ordering operator<=>(metall::offset_ptr<BNodeBackend> const &other) const noexcept;
 
-    [[nodiscard]] std::string_view identifier() const noexcept;
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string_view identifier(StringArena<Policy> const &arena) const noexcept {
+        return arena.view(identifier_);
+    }
 
-    explicit operator view::BNodeBackendView() const noexcept;
-};
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::BNodeBackendView view(StringArena<Policy> const &arena) const noexcept {
+        return {.identifier = identifier(arena)};
+    }
 
-std::partial_ordering operator<=>(metall::offset_ptr<BNodeBackend> const &self, metall::offset_ptr<BNodeBackend> const &other) noexcept;
-}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+    /**
+     * The record is contiguous in the arena, buffer is not used. Same interface as IRIBackend.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::BNodeBackendView view(StringArena<Policy> const &arena, [[maybe_unused]] std::string &buffer) const noexcept {
+        return view(arena);
+    }
 
-namespace rdf4cpp::rdf::storage::node::view {
-inline std::partial_ordering operator<=>(BNodeBackendView const &lhs, metall::offset_ptr<metall_node_storage::BNodeBackend> const &rhs) noexcept {
-    return lhs <=> BNodeBackendView(*rhs);
-}
-}  // namespace rdf4cpp::rdf::storage::node::view
+    template<StoragePolicy Policy>
+    [[nodiscard]] bool equals(StringArena<Policy> const &arena, view::BNodeBackendView const &view) const noexcept {
+        return std::is_eq(this->view(arena) <=> view);
+    }
+};
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
 #endif  //METALL_BNODEBACKEND_HPP
@@ -0,0 +1,118 @@
+#include "Compaction.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+using NodeID = identifier::NodeID;
+
+/**
+ * Copies the live records of one node type. translate(id, view) returns the view to store for a record, or nothing to skip it.
+ */
+template<typename SourcePolicy, typename Backend_t, typename Key_t, typename SourceArena_t, typename TargetArena_t, typename Translate_t>
+void copy_nodes(std::string_view node_type, DenseIDTable<SourcePolicy, Backend_t, Key_t> const &source_storage, SourceArena_t const &source_arena,
+                DenseIDTable<MetallPolicy, Backend_t, Key_t> &target_storage, StripedHashIndex<MetallPolicy> &target_reverse, TargetArena_t &target_arena,
+                std::atomic<uint64_t> &target_next_id, uint64_t source_next_id, CompactionOptions const &options,
+                Translate_t const &translate, std::vector<std::pair<NodeID, NodeID>> &remapped_ids, CompactionResult &result) {
+    uint64_t const total = source_storage.size();
+    uint64_t done = 0;
+    auto const report = [&]() {
+        if (options.progress)
+            options.progress(CompactionProgress{.node_type = node_type, .records_done = done, .records_total = total});
+    };
+
+    std::string buffer;
+    source_storage.for_each([&](NodeID id, Backend_t const &record) {
+        if (++done % options.progress_interval == 0)
+            report();
+
+        auto const source_view = record.view(source_arena, buffer);
+        auto const view = translate(id, source_view);
+        if (!view.has_value())
+            return;
+
+        // the stored hash stays valid unless translate changed the view, e.g. the datatype of a literal
+        uint64_t const hash = std::is_eq(*view <=> source_view) ? source_storage.hash(id) : ViewHash{}(*view);
+        NodeID const new_id = options.remap_ids ? Key_t::id(target_next_id.fetch_add(1)) : id;
+        target_storage.insert(new_id, Backend_t{target_arena, *view}, hash);
+        target_reverse.stripe(target_reverse.stripe_of(hash)).insert(hash, new_id);
+
+        if (options.remap_ids)
+            remapped_ids.emplace_back(id, new_id);
+        ++result.records_copied;
+    });
+    result.records_dropped += source_storage.erased_count();
+
+    if (!options.remap_ids)
+        target_next_id = std::max(target_next_id.load(), source_next_id);
+    report();
+}
+
+template<StoragePolicy Policy>
+CompactionResult compact(BasicNodeStore<Policy> const &source, metall::manager &target, char const *store_name, CompactionOptions const &options) {
+    if (target.read_only())
+        throw std::runtime_error("Cannot compact into a read-only datastore.");
+    if (target.find<MetallNodeStore>(store_name).first != nullptr)
+        throw std::runtime_error("The target datastore already contains a node store named " + std::string{store_name} + ".");
+
+    MetallNodeStore &store = *target.find_or_construct<MetallNodeStore>(store_name)(target.get_allocator());
+    // a store left behind by a failed copy would block the next attempt with the same name
+    try {
+        if (store.inlined_datatype_ids != source.inlined_datatype_ids)
+            throw std::runtime_error("The inlined datatype IRIs of the source store do not match this build.");
+
+        CompactionResult result;
+        result.arena_bytes_before = source.literal_arena->bytes_used() + source.bnode_arena->bytes_used() +
+                                    source.iri_arena->bytes_used() + source.variable_arena->bytes_used();
+
+        // IRIs first, literals refer to their datatype IRI
+        std::vector<NodeID> builtin_iris{source.inlined_datatype_ids.begin(), source.inlined_datatype_ids.end()};
+        for (const auto &[id, iri] : NodeID::predefined_iris)
+            builtin_iris.push_back(id);
+
+        std::unordered_map<uint64_t, NodeID> iri_remap;
+        copy_nodes("iri", *source.iri_storage, *source.iri_arena, *store.iri_storage, *store.iri_storage_reverse, *store.iri_arena,
+                   store.next_iri_id, source.next_iri_id.load(), options,
+                   [&](NodeID id, view::IRIBackendView view) -> std::optional<view::IRIBackendView> {
+                       // already part of the new store, with the same ID
+                       if (std::find(builtin_iris.begin(), builtin_iris.end(), id) != builtin_iris.end())
+                           return std::nullopt;
+                       return view;
+                   },
+                   result.remapped_ids.iri, result);
+        for (auto const &[old_id, new_id] : result.remapped_ids.iri)
+            iri_remap.emplace(old_id.value(), new_id);
+
+        copy_nodes("literal", *source.literal_storage, *source.literal_arena, *store.literal_storage, *store.literal_storage_reverse, *store.literal_arena,
+                   store.next_literal_id, source.next_literal_id.load(), options,
+                   [&](NodeID, view::LiteralBackendView view) -> std::optional<view::LiteralBackendView> {
+                       if (auto it = iri_remap.find(view.datatype_id.value()); it != iri_remap.end())
+                           view.datatype_id = it->second;
+                       return view;
+                   },
+                   result.remapped_ids.literal, result);
+        copy_nodes("bnode", *source.bnode_storage, *source.bnode_arena, *store.bnode_storage, *store.bnode_storage_reverse, *store.bnode_arena,
+                   store.next_bnode_id, source.next_bnode_id.load(), options,
+                   [](NodeID, view::BNodeBackendView view) -> std::optional<view::BNodeBackendView> { return view; },
+                   result.remapped_ids.bnode, result);
+        copy_nodes("variable", *source.variable_storage, *source.variable_arena, *store.variable_storage, *store.variable_storage_reverse, *store.variable_arena,
+                   store.next_variable_id, source.next_variable_id.load(), options,
+                   [](NodeID, view::VariableBackendView view) -> std::optional<view::VariableBackendView> { return view; },
+                   result.remapped_ids.variable, result);
+
+        result.arena_bytes_after = store.literal_arena->bytes_used() + store.bnode_arena->bytes_used() +
+                                   store.iri_arena->bytes_used() + store.variable_arena->bytes_used();
+        return result;
+    } catch (...) {
+        target.destroy<MetallNodeStore>(store_name);
+        throw;
+    }
+}
+
+template CompactionResult compact(MetallNodeStore const &, metall::manager &, char const *, CompactionOptions const &);
+template CompactionResult compact(BasicNodeStore<HeapPolicy> const &, metall::manager &, char const *, CompactionOptions const &);
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef METALL_COMPACTION_HPP
+#define METALL_COMPACTION_HPP
+
+#include <metall/metall.hpp>
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include "MetallNodeStore.hpp"
+#include "StoragePolicy.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+struct CompactionProgress {
+    std::string_view node_type;
+    uint64_t records_done;
+    /**
+     * Upper bound, gaps in the forward table are included.
+     */
+    uint64_t records_total;
+};
+
+struct CompactionOptions {
+    /**
+     * Assign new dense IDs instead of keeping the old ones. Only then the forward tables lose the gaps left by erased nodes,
+     * but every holder of an old ID has to translate it with CompactionResult::remapped_ids.
+     * Inlined literals, the predefined IRIs and the inlined datatype IRIs always keep their IDs.
+     */
+    bool remap_ids = false;
+    /**
+     * Called every progress_interval records and once at the end of every node type.
+     */
+    std::function<void(CompactionProgress const &)> progress;
+    uint64_t progress_interval = uint64_t{1} << 20;
+};
+
+struct CompactionResult {
+    using NodeID = identifier::NodeID;
+
+    /**
+     * Old -> new ID of every copied node, sorted by the old ID. Only filled with CompactionOptions::remap_ids.
+     */
+    struct IDRemap {
+        std::vector<std::pair<NodeID, NodeID>> literal;
+        std::vector<std::pair<NodeID, NodeID>> bnode;
+        std::vector<std::pair<NodeID, NodeID>> iri;
+        std::vector<std::pair<NodeID, NodeID>> variable;
+    };
+
+    uint64_t records_copied = 0;
+    uint64_t records_dropped = 0;
+    uint64_t arena_bytes_before = 0;
+    uint64_t arena_bytes_after = 0;
+    IDRemap remapped_ids;
+};
+
+/**
+ * Copies all nodes of source that were not erased into a new MetallNodeStore named store_name in target.
+ * source may use any StoragePolicy, e.g. to persist an in-memory store.
+ * Only live strings are copied, so the new arenas hold no space of erased nodes.
+ * source may be read concurrently, but not written, see DenseIDTable::for_each. BasicNodeStorageBackend::compact_into pauses its writers.
+ * If the copy fails, the partly written store is destroyed again, so that target is left as it was.
+ * @throws std::runtime_error if target is read-only or already contains a store named store_name
+ */
+template<StoragePolicy Policy>
+CompactionResult compact(BasicNodeStore<Policy> const &source, metall::manager &target, char const *store_name,
+                         CompactionOptions const &options = {});
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_COMPACTION_HPP
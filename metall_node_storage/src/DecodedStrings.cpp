@@ -0,0 +1,91 @@
+#include "DecodedStrings.hpp"
+
+#include <cstring>
+#include <new>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Spreads the keys, which are often consecutive ids, over the table (splitmix64 finalizer).
+ */
+static size_t slot_of(uint64_t key) noexcept {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+DecodedStrings::Table::Table(size_t capacity) : mask(capacity - 1), slots(std::make_unique<std::atomic<Header const *>[]>(capacity)) {}
+
+DecodedStrings::DecodedStrings() {
+    tables_.push_back(std::make_unique<Table>(initial_capacity));
+    bytes_reserved_ = initial_capacity * sizeof(std::atomic<Header const *>);
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+DecodedStrings::Header const *DecodedStrings::find(Table const &table, uint64_t key) noexcept {
+    for (size_t slot = slot_of(key) & table.mask;; slot = (slot + 1) & table.mask) {
+        Header const *header = table.slots[slot].load(std::memory_order_acquire);
+        if (header == nullptr || header->key == key)
+            return header;
+    }
+}
+
+void DecodedStrings::insert(Table &table, Header const *header) noexcept {
+    size_t slot = slot_of(header->key) & table.mask;
+    while (table.slots[slot].load(std::memory_order_relaxed) != nullptr)
+        slot = (slot + 1) & table.mask;
+    table.slots[slot].store(header, std::memory_order_release);
+}
+
+DecodedStrings::Header const *DecodedStrings::append(uint64_t key, std::string_view str) {
+    // keeps the headers aligned
+    size_t const record_size = (sizeof(Header) + str.size() + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+    std::byte *record;
+    if (record_size > chunk_size / 4) {
+        // large strings get a chunk of their own, the open chunk stays open
+        record = chunks_.emplace_back(std::make_unique<std::byte[]>(record_size)).get();
+        bytes_reserved_.fetch_add(record_size, std::memory_order_relaxed);
+    } else {
+        if (open_chunk_used_ + record_size > chunk_size) {
+            open_chunk_ = chunks_.emplace_back(std::make_unique<std::byte[]>(chunk_size)).get();
+            open_chunk_used_ = 0;
+            bytes_reserved_.fetch_add(chunk_size, std::memory_order_relaxed);
+        }
+        record = open_chunk_ + open_chunk_used_;
+        open_chunk_used_ += record_size;
+    }
+
+    auto *header = new (record) Header{key, str.size()};
+    std::memcpy(header + 1, str.data(), str.size());
+    return header;
+}
+
+std::string_view DecodedStrings::add(uint64_t key, std::string_view str) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    Table &table = *tables_.back();
+    if (Header const *found = find(table, key); found != nullptr)
+        return string_of(found);
+
+    Header const *header = append(key, str);
+    if ((size_ + 1) * 2 > table.mask + 1) {
+        // readers of the old table only miss the new key and come here
+        auto grown = std::make_unique<Table>((table.mask + 1) * 2);
+        for (size_t slot = 0; slot <= table.mask; ++slot) {
+            if (Header const *moved = table.slots[slot].load(std::memory_order_relaxed); moved != nullptr)
+                insert(*grown, moved);
+        }
+        insert(*grown, header);
+        bytes_reserved_.fetch_add((grown->mask + 1) * sizeof(std::atomic<Header const *>), std::memory_order_relaxed);
+        table_.store(grown.get(), std::memory_order_release);
+        tables_.push_back(std::move(grown));
+    } else {
+        insert(table, header);
+    }
+    ++size_;
+    return string_of(header);
+}
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
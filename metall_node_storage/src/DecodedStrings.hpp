@@ -0,0 +1,102 @@
+#ifndef METALL_DECODEDSTRINGS_HPP
+#define METALL_DECODEDSTRINGS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Process-local copies of strings that have no contiguous record, e.g. prefix-compressed IRIs or inlined literals.
+ * Each key is decoded at most once into an append-only arena and never moved or freed, so views of it stay valid
+ * for as long as this object exists. Memory grows with the number of distinct keys that were viewed.
+ *
+ * Lookups are lock-free: an open-addressing table of atomic pointers into the arena, published with release stores.
+ * Adding a key takes a mutex. A grown table replaces the old one, which is kept for readers that still probe it.
+ */
+class DecodedStrings {
+    /**
+     * Arena record: key, length, then the bytes. Slots point to it, nullptr marks an empty slot.
+     */
+    struct Header {
+        uint64_t key;
+        uint64_t size;
+    };
+
+    struct Table {
+        size_t mask;
+        std::unique_ptr<std::atomic<Header const *>[]> slots;
+
+        explicit Table(size_t capacity);
+    };
+
+    static constexpr size_t initial_capacity = 64;
+    static constexpr size_t chunk_size = size_t{1} << 16;
+
+    std::atomic<Table const *> table_;
+
+    std::mutex mutex_;
+    /**
+     * All tables ever used, the last one is current.
+     */
+    std::vector<std::unique_ptr<Table>> tables_;
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    std::byte *open_chunk_ = nullptr;
+    size_t open_chunk_used_ = chunk_size;
+    size_t size_ = 0;
+    std::atomic<uint64_t> bytes_reserved_ = 0;
+
+    [[nodiscard]] static std::string_view string_of(Header const *header) noexcept {
+        return {reinterpret_cast<char const *>(header + 1), header->size};
+    }
+
+    [[nodiscard]] static Header const *find(Table const &table, uint64_t key) noexcept;
+    static void insert(Table &table, Header const *header) noexcept;
+    [[nodiscard]] Header const *append(uint64_t key, std::string_view str);
+
+public:
+    DecodedStrings();
+
+    DecodedStrings(DecodedStrings const &) = delete;
+    DecodedStrings &operator=(DecodedStrings const &) = delete;
+
+    /**
+     * @return the string of key, or nullptr data if it was not added yet
+     */
+    [[nodiscard]] std::string_view find(uint64_t key) const noexcept {
+        Header const *header = find(*table_.load(std::memory_order_acquire), key);
+        return header != nullptr ? string_of(header) : std::string_view{};
+    }
+
+    /**
+     * @return the string of key, which str is added as unless another thread was first
+     */
+    std::string_view add(uint64_t key, std::string_view str);
+
+    /**
+     * @param decode called as decode(std::string &buffer) -> std::string_view if key was not added yet
+     */
+    template<typename Decode_t>
+    [[nodiscard]] std::string_view find_or_decode(uint64_t key, Decode_t &&decode) {
+        if (std::string_view const found = find(key); found.data() != nullptr)
+            return found;
+        thread_local std::string buffer;
+        return add(key, decode(buffer));
+    }
+
+    /**
+     * Bytes allocated for the copies and tables.
+     */
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return bytes_reserved_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_DECODEDSTRINGS_HPP
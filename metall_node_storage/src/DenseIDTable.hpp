@@ -0,0 +1,381 @@
+#ifndef METALL_DENSEIDTABLE_HPP
+#define METALL_DENSEIDTABLE_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include "StoragePolicy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Maps a NodeID to its position in a DenseIDTable, for IRIs, blank nodes and variables.
+ */
+struct NodeIDKey {
+    [[nodiscard]] static uint64_t of(identifier::NodeID id) noexcept {
+        return id.value();
+    }
+
+    [[nodiscard]] static identifier::NodeID id(uint64_t key) noexcept {
+        return identifier::NodeID{key};
+    }
+};
+
+/**
+ * Maps a literal NodeID to its position in a DenseIDTable. The LiteralType bits are ignored.
+ */
+struct LiteralIDKey {
+    [[nodiscard]] static uint64_t of(identifier::NodeID id) noexcept {
+        return id.literal_id().value;
+    }
+
+    /**
+     * Only literals of LiteralType::OTHER are stored.
+     */
+    [[nodiscard]] static identifier::NodeID id(uint64_t key) noexcept {
+        return identifier::NodeID{identifier::LiteralID{key}, identifier::LiteralType::OTHER};
+    }
+};
+
+/**
+ * Persistent forward table NodeID -> backend record.
+ * IDs are handed out sequentially, so the records are stored inline and indexed by (key - first_key).
+ * Backend_t must be default-constructible into a null() record, which marks gaps.
+ *
+ * The records live in segments that are allocated on demand and never move. The first segment holds
+ * first_segment_size records and every further one doubles the capacity, so an empty table stays small
+ * and the segment directory has a fixed, short length.
+ * Segments are published with an atomic compare-exchange, so readers never take a lock:
+ * a lookup is one atomic load of the segment plus one indexed load of the record.
+ * insert may be called concurrently for different ids.
+ * A record may be read by other threads once its id was published to them, e.g. through a lock of the reverse index.
+ *
+ * Erasing only sets a tombstone bit next to the record. The record itself is never overwritten,
+ * so a concurrent reader sees either the live record or the tombstone, never a torn record.
+ * The space is reclaimed by compacting into a fresh datastore, see Compaction.hpp.
+ */
+template<StoragePolicy Policy, typename Backend_t, typename Key_t = NodeIDKey>
+class DenseIDTable {
+public:
+    using NodeID = identifier::NodeID;
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+    static constexpr unsigned first_segment_bits = 10;
+    static constexpr size_t first_segment_size = size_t{1} << first_segment_bits;
+    /**
+     * Segment i > 0 holds the indices [2^(first_segment_bits + i - 1), 2^(first_segment_bits + i)).
+     */
+    static constexpr size_t max_segments = 64 - first_segment_bits + 1;
+
+private:
+    /**
+     * The record and the ViewHash of its view, so that erase, compaction and export do not have to hash it again.
+     * Lookups compare the hash kept in the index slot or front cache entry instead.
+     */
+    struct Entry {
+        Backend_t record{};
+        uint64_t hash = 0;
+    };
+
+    static constexpr size_t block_size = 64;
+
+    /**
+     * Segments are arrays of blocks, which keep the tombstone bits next to their records.
+     */
+    struct Block {
+        std::array<Entry, block_size> records{};
+        /**
+         * One tombstone bit per record.
+         */
+        std::atomic<uint64_t> erased = 0;
+    };
+
+    using BlockAlloc = typename Policy::template allocator_type<Block>;
+
+    /**
+     * Segment and index within the segment of a position in the table.
+     */
+    struct Position {
+        size_t segment;
+        uint64_t offset;
+    };
+
+    Alloc alloc_;
+    uint64_t first_key_;
+    /**
+     * Segment addresses relative to this object, 0 for segments that are not allocated yet.
+     * Relative offsets keep the table position-independent like offset_ptr, but unlike offset_ptr they can be atomic.
+     */
+    std::array<std::atomic<std::ptrdiff_t>, max_segments> segments_{};
+    /**
+     * One past the largest index that was inserted.
+     */
+    std::atomic<uint64_t> size_ = 0;
+    /**
+     * Records inserted over the lifetime of the table. Unlike size_ it changes with every insert, also below size_.
+     */
+    std::atomic<uint64_t> insert_count_ = 0;
+    std::atomic<uint64_t> erased_count_ = 0;
+    std::atomic<uint64_t> bytes_reserved_ = 0;
+
+    [[nodiscard]] static constexpr uint64_t segment_start(size_t i) noexcept {
+        return i == 0 ? 0 : uint64_t{1} << (first_segment_bits + i - 1);
+    }
+
+    [[nodiscard]] static constexpr uint64_t segment_capacity(size_t i) noexcept {
+        return i == 0 ? first_segment_size : segment_start(i);
+    }
+
+    [[nodiscard]] static Position position(uint64_t index) noexcept {
+        if (index < first_segment_size)
+            return {.segment = 0, .offset = index};
+        size_t const i = std::bit_width(index) - first_segment_bits;
+        return {.segment = i, .offset = index - segment_start(i)};
+    }
+
+    [[nodiscard]] static Entry &entry(Block *segment, uint64_t offset) noexcept {
+        return segment[offset / block_size].records[offset % block_size];
+    }
+
+    [[nodiscard]] static Entry const &entry(Block const *segment, uint64_t offset) noexcept {
+        return segment[offset / block_size].records[offset % block_size];
+    }
+
+    [[nodiscard]] Block *segment_address(std::ptrdiff_t relative) const noexcept {
+        return reinterpret_cast<Block *>(reinterpret_cast<char *>(const_cast<DenseIDTable *>(this)) + relative);
+    }
+
+    [[nodiscard]] Block *segment(size_t i) const noexcept {
+        std::ptrdiff_t const relative = segments_[i].load(std::memory_order_acquire);
+        return relative == 0 ? nullptr : segment_address(relative);
+    }
+
+    Block *ensure_segment(size_t i) {
+        std::ptrdiff_t relative = segments_[i].load(std::memory_order_acquire);
+        if (relative != 0)
+            return segment_address(relative);
+
+        size_t const blocks = segment_capacity(i) / block_size;
+        BlockAlloc block_alloc = alloc_;
+        auto const fresh = block_alloc.allocate(blocks);
+        Block *const raw = &*fresh;
+        std::uninitialized_value_construct_n(raw, blocks);
+
+        std::ptrdiff_t const fresh_relative = reinterpret_cast<char *>(raw) - reinterpret_cast<char *>(this);
+        if (segments_[i].compare_exchange_strong(relative, fresh_relative, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            bytes_reserved_.fetch_add(blocks * sizeof(Block), std::memory_order_relaxed);
+            return raw;
+        }
+
+        // another insert published the segment first
+        std::destroy_n(raw, blocks);
+        block_alloc.deallocate(fresh, blocks);
+        return segment_address(relative);
+    }
+
+    /**
+     * @return the segment holding pos, or nullptr if index was never inserted
+     */
+    [[nodiscard]] Block const *find_segment(uint64_t index, Position pos) const noexcept {
+        if (index >= size_.load(std::memory_order_acquire))
+            return nullptr;
+        return segment(pos.segment);
+    }
+
+    [[nodiscard]] static bool is_erased(Block const *segment, uint64_t offset) noexcept {
+        return (segment[offset / block_size].erased.load(std::memory_order_acquire) >> (offset % block_size)) & 1;
+    }
+
+    [[nodiscard]] static bool live(Block const *segment, uint64_t offset) noexcept {
+        return segment != nullptr && !entry(segment, offset).record.null() && !is_erased(segment, offset);
+    }
+
+public:
+    DenseIDTable(Alloc const &alloc, uint64_t first_key) : alloc_(alloc), first_key_(first_key) {}
+
+    ~DenseIDTable() {
+        BlockAlloc block_alloc = alloc_;
+        for (size_t i = 0; i < max_segments; ++i) {
+            if (Block *seg = segment(i); seg != nullptr) {
+                size_t const blocks = segment_capacity(i) / block_size;
+                std::destroy_n(seg, blocks);
+                block_alloc.deallocate(typename std::allocator_traits<BlockAlloc>::pointer(seg), blocks);
+            }
+        }
+    }
+
+    DenseIDTable(DenseIDTable const &) = delete;
+    DenseIDTable &operator=(DenseIDTable const &) = delete;
+
+    /**
+     * Stores the record for id. Ids that are never inserted stay null records.
+     * @param hash ViewHash of the record's view
+     */
+    void insert(NodeID id, Backend_t const &backend, uint64_t hash) {
+        uint64_t const index = Key_t::of(id) - first_key_;
+        Position const pos = position(index);
+        entry(ensure_segment(pos.segment), pos.offset) = Entry{.record = backend, .hash = hash};
+
+        uint64_t size = size_.load(std::memory_order_relaxed);
+        while (size < index + 1 && !size_.compare_exchange_weak(size, index + 1, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        insert_count_.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * Marks the record for id as erased.
+     * @return false if there is no live record for id
+     */
+    bool erase(NodeID id) noexcept {
+        uint64_t const key = Key_t::of(id);
+        if (key < first_key_ || key - first_key_ >= size())
+            return false;
+        Position const pos = position(key - first_key_);
+        Block *const seg = segment(pos.segment);
+        if (seg == nullptr || entry(seg, pos.offset).record.null())
+            return false;
+
+        uint64_t const bit = uint64_t{1} << (pos.offset % block_size);
+        if (seg[pos.offset / block_size].erased.fetch_or(bit, std::memory_order_acq_rel) & bit)
+            return false;
+        erased_count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @return true if there is a record for id that was not erased
+     */
+    [[nodiscard]] bool contains(NodeID id) const noexcept {
+        uint64_t const key = Key_t::of(id);
+        if (key < first_key_)
+            return false;
+        Position const pos = position(key - first_key_);
+        return live(find_segment(key - first_key_, pos), pos.offset);
+    }
+
+    /**
+     * @throws std::out_of_range if there is no record for id or it was erased
+     */
+    [[nodiscard]] Backend_t const &at(NodeID id) const {
+        uint64_t const key = Key_t::of(id);
+        if (key < first_key_)
+            throw std::out_of_range("No node stored for the given NodeID.");
+
+        Position const pos = position(key - first_key_);
+        Block const *const seg = find_segment(key - first_key_, pos);
+        if (!live(seg, pos.offset))
+            throw std::out_of_range("No node stored for the given NodeID.");
+        return entry(seg, pos.offset).record;
+    }
+
+    /**
+     * Unchecked access for ids that are known to be stored, e.g. the ones held by a HashIndex.
+     * Erased records stay readable.
+     */
+    [[nodiscard]] Backend_t const &operator[](NodeID id) const noexcept {
+        Position const pos = position(Key_t::of(id) - first_key_);
+        return entry(segment(pos.segment), pos.offset).record;
+    }
+
+    /**
+     * Unchecked access to the hash stored with the record of id, like operator[].
+     */
+    [[nodiscard]] uint64_t hash(NodeID id) const noexcept {
+        Position const pos = position(Key_t::of(id) - first_key_);
+        return entry(segment(pos.segment), pos.offset).hash;
+    }
+
+    /**
+     * Hints the CPU to load the record of id into the cache. Does nothing if id was never inserted.
+     */
+    void prefetch(NodeID id) const noexcept {
+        uint64_t const index = Key_t::of(id) - first_key_;
+        Position const pos = position(index);
+        if (Block const *const seg = find_segment(index, pos); seg != nullptr)
+            __builtin_prefetch(&entry(seg, pos.offset));
+    }
+
+    /**
+     * Calls f(NodeID, Backend_t const &) for every live record, in ascending id order.
+     * Requires writers to be paused: insert writes a record before it bumps size_, and ids do not arrive in order,
+     * so a record below size() may still be written while it is read.
+     */
+    template<typename F>
+    void for_each(F &&f) const {
+        uint64_t const end = size();
+        for (size_t i = 0; i < max_segments && segment_start(i) < end; ++i) {
+            Block const *const seg = segment(i);
+            if (seg == nullptr)
+                continue;
+            uint64_t const count = std::min(segment_capacity(i), end - segment_start(i));
+            for (uint64_t offset = 0; offset < count; ++offset) {
+                if (live(seg, offset))
+                    f(Key_t::id(first_key_ + segment_start(i) + offset), entry(seg, offset).record);
+            }
+        }
+    }
+
+    /**
+     * Calls f(void const *address, size_t bytes) for every allocated segment.
+     */
+    template<typename F>
+    void for_each_segment(F &&f) const {
+        uint64_t const end = size();
+        for (size_t i = 0; i < max_segments && segment_start(i) < end; ++i) {
+            if (Block const *const seg = segment(i); seg != nullptr)
+                f(static_cast<void const *>(seg), segment_capacity(i) / block_size * sizeof(Block));
+        }
+    }
+
+    [[nodiscard]] uint64_t first_key() const noexcept {
+        return first_key_;
+    }
+
+    /**
+     * One past the largest position that was inserted, including erased records and gaps.
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t insert_count() const noexcept {
+        return insert_count_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t erased_count() const noexcept {
+        return erased_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Bytes of all allocated segments.
+     */
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return bytes_reserved_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Bytes of the records up to size(), including erased records and gaps.
+     */
+    [[nodiscard]] uint64_t bytes_used() const noexcept {
+        return size() * sizeof(Entry);
+    }
+
+    /**
+     * Allocates the segments for the first n records up front.
+     */
+    void reserve(size_t n) {
+        for (size_t i = 0; i < max_segments && segment_start(i) < n; ++i)
+            ensure_segment(i);
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_DENSEIDTABLE_HPP
@@ -0,0 +1,84 @@
+#ifndef METALL_FRONTCACHE_HPP
+#define METALL_FRONTCACHE_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Hit/miss counters of a FrontCache.
+ */
+struct FrontCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    FrontCacheStats &operator+=(FrontCacheStats const &other) noexcept {
+        hits += other.hits;
+        misses += other.misses;
+        return *this;
+    }
+};
+
+/**
+ * Small direct-mapped cache view hash -> NodeID that sits in front of a HashIndex.
+ * It is meant to be used by a single thread, so it needs no synchronization.
+ * Entries are not invalidated when a node is erased, so a cached NodeID may point to a tombstone.
+ * Correctness depends on the caller confirming every hit, as lookup_or_insert_impl in MetallNodeStorageBackend does with
+ * storage->contains(id) && equal(id): contains rejects erased records and equal rejects hash collisions.
+ */
+template<unsigned entry_bits = 10>
+class FrontCache {
+public:
+    using NodeID = identifier::NodeID;
+
+    static constexpr size_t entry_count = size_t{1} << entry_bits;
+
+private:
+    struct Entry {
+        uint64_t hash = 0;
+        NodeID id{};
+    };
+
+    std::array<Entry, entry_count> entries_{};
+    FrontCacheStats stats_;
+
+public:
+    /**
+     * @param equal called as equal(NodeID) if the entry for hash is occupied by the same hash
+     * @return the cached NodeID, or the null NodeID on a miss
+     */
+    template<typename Equal_t>
+    [[nodiscard]] NodeID find(uint64_t hash, Equal_t const &equal) noexcept {
+        Entry const &entry = entries_[hash & (entry_count - 1)];
+        if (!entry.id.null() && entry.hash == hash && equal(entry.id)) {
+            ++stats_.hits;
+            return entry.id;
+        }
+        ++stats_.misses;
+        return {};
+    }
+
+    /**
+     * Replaces whatever was cached in the entry for hash.
+     */
+    void insert(uint64_t hash, NodeID id) noexcept {
+        entries_[hash & (entry_count - 1)] = Entry{.hash = hash, .id = id};
+    }
+
+    /**
+     * Drops all entries. The counters are kept.
+     */
+    void clear() noexcept {
+        entries_.fill(Entry{});
+    }
+
+    [[nodiscard]] FrontCacheStats const &stats() const noexcept {
+        return stats_;
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_FRONTCACHE_HPP
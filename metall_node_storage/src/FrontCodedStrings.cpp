@@ -0,0 +1,90 @@
+#include "FrontCodedStrings.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+namespace {
+void write_varint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline uint64_t read_varint(char const *&p) noexcept {
+    uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        auto const byte = static_cast<unsigned char>(*p++);
+        value |= uint64_t{byte & 0x7fU} << shift;
+        if (byte < 0x80)
+            return value;
+    }
+}
+
+inline size_t common_prefix(std::string_view a, std::string_view b) noexcept {
+    return static_cast<size_t>(std::mismatch(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(std::min(a.size(), b.size())), b.begin()).first - a.begin());
+}
+}  // namespace
+
+FrontCodedStrings::Encoded FrontCodedStrings::encode(std::span<std::string_view const> strings, uint32_t bucket_size) {
+    if (bucket_size == 0)
+        throw std::invalid_argument("The bucket size of FrontCodedStrings must be at least 1.");
+
+    Encoded encoded;
+    encoded.locations.reserve(strings.size());
+    uint64_t bucket = 0;
+    std::string_view head;
+    uint32_t in_bucket = 0;
+    for (std::string_view const str : strings) {
+        uint64_t const offset = encoded.bytes.size() - bucket;
+        if (in_bucket == 0 || in_bucket == bucket_size || offset > offset_mask) {
+            bucket = encoded.bytes.size();
+            if (bucket >> (64 - offset_bits) != 0)
+                throw std::length_error("FrontCodedStrings can address at most 2^40 bytes.");
+            encoded.locations.push_back(bucket << offset_bits);
+            write_varint(encoded.bytes, str.size());
+            encoded.bytes.append(str);
+            head = str;
+            in_bucket = 1;
+            continue;
+        }
+        encoded.locations.push_back((bucket << offset_bits) | offset);
+        size_t const shared = common_prefix(head, str);
+        write_varint(encoded.bytes, shared);
+        write_varint(encoded.bytes, str.size() - shared);
+        encoded.bytes.append(str.substr(shared));
+        ++in_bucket;
+    }
+    return encoded;
+}
+
+std::string_view FrontCodedStrings::get(uint64_t location, std::string &buffer) const {
+    char const *head = bytes_ + (location >> offset_bits);
+    uint64_t const head_length = read_varint(head);
+    if (contiguous(location))
+        return {head, head_length};
+
+    char const *p = bytes_ + (location >> offset_bits) + (location & offset_mask);
+    uint64_t const shared = read_varint(p);
+    uint64_t const rest = read_varint(p);
+    buffer.assign(head, shared);
+    buffer.append(p, rest);
+    return buffer;
+}
+
+bool FrontCodedStrings::equals(uint64_t location, std::string_view str) const noexcept {
+    char const *head = bytes_ + (location >> offset_bits);
+    uint64_t const head_length = read_varint(head);
+    if (contiguous(location))
+        return head_length == str.size() && std::memcmp(head, str.data(), head_length) == 0;
+
+    char const *p = bytes_ + (location >> offset_bits) + (location & offset_mask);
+    uint64_t const shared = read_varint(p);
+    uint64_t const rest = read_varint(p);
+    return shared + rest == str.size() && std::memcmp(head, str.data(), shared) == 0 && std::memcmp(p, str.data() + shared, rest) == 0;
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
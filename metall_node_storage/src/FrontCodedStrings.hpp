@@ -0,0 +1,74 @@
+#ifndef METALL_FRONTCODEDSTRINGS_HPP
+#define METALL_FRONTCODEDSTRINGS_HPP
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Immutable run of strings, front-coded in buckets of up to bucket_size strings.
+ * The first string of a bucket, its head, is stored whole. Every other one is stored as the length of the prefix it shares
+ * with the head plus the rest. Lengths are LEB128 varints. Sorted input compresses best, e.g. IRIs of one namespace.
+ *
+ * A string is addressed by its location: the byte offset of its bucket in the upper 40 bits and the offset of the string
+ * in the bucket in the lower 24 bits. Locations grow with the order of the strings.
+ * Coding against the head instead of the predecessor keeps reading a string independent of its position in the bucket:
+ * it touches the head and the string only, so bucket_size trades size for nothing but locality of the bytes.
+ * A head can be viewed in place without decoding.
+ * Used in place on memory the caller keeps alive, e.g. a mapped file.
+ */
+class FrontCodedStrings {
+public:
+    static constexpr unsigned offset_bits = 24;
+
+private:
+    static constexpr uint64_t offset_mask = (uint64_t{1} << offset_bits) - 1;
+
+    char const *bytes_ = nullptr;
+
+public:
+    /**
+     * Output of encode, to be stored by the caller.
+     */
+    struct Encoded {
+        std::string bytes;
+        /**
+         * Location of every input string.
+         */
+        std::vector<uint64_t> locations;
+    };
+
+    FrontCodedStrings() noexcept = default;
+    explicit FrontCodedStrings(char const *bytes) noexcept : bytes_(bytes) {}
+
+    /**
+     * Buckets end early where the next string would not be addressable by a location.
+     * @throws std::invalid_argument if bucket_size is 0
+     * @throws std::length_error if the bytes exceed what locations can address
+     */
+    [[nodiscard]] static Encoded encode(std::span<std::string_view const> strings, uint32_t bucket_size);
+
+    /**
+     * @return true if the string at location is a head, so that get does not need its buffer
+     */
+    [[nodiscard]] static bool contiguous(uint64_t location) noexcept {
+        return (location & offset_mask) == 0;
+    }
+
+    /**
+     * @return the string at location, pointing into buffer unless it is contiguous. Valid until buffer is modified.
+     */
+    [[nodiscard]] std::string_view get(uint64_t location, std::string &buffer) const;
+
+    /**
+     * Compares the string at location to str without materializing it.
+     */
+    [[nodiscard]] bool equals(uint64_t location, std::string_view str) const noexcept;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_FRONTCODEDSTRINGS_HPP
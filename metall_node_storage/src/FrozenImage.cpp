@@ -0,0 +1,202 @@
+#include "FrozenImage.hpp"
+
+#include "FrontCodedStrings.hpp"
+#include "MinimalPerfectHash.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+using NodeID = identifier::NodeID;
+
+/**
+ * Appends 8-byte aligned sections to an image file. The header is written last, so that a partially written image is rejected.
+ */
+class ImageWriter {
+    std::ofstream out_;
+    std::string path_;
+    uint64_t size_ = sizeof(FrozenImageHeader);
+
+    void check() const {
+        if (!out_)
+            throw std::runtime_error("Could not write the frozen image " + path_ + ".");
+    }
+
+public:
+    explicit ImageWriter(char const *path) : out_(path, std::ios::binary | std::ios::trunc), path_(path) {
+        FrozenImageHeader blank;
+        blank.magic_ = 0;
+        out_.write(reinterpret_cast<char const *>(&blank), sizeof(blank));
+        check();
+    }
+
+    /**
+     * @return offset of the section in the file
+     */
+    uint64_t write(void const *data, uint64_t bytes) {
+        static constexpr char padding[8]{};
+        out_.write(padding, static_cast<std::streamsize>((8 - size_ % 8) % 8));
+        size_ = (size_ + 7) & ~uint64_t{7};
+        uint64_t const offset = size_;
+        out_.write(static_cast<char const *>(data), static_cast<std::streamsize>(bytes));
+        size_ += bytes;
+        check();
+        return offset;
+    }
+
+    template<typename T>
+    uint64_t write(std::vector<T> const &data) {
+        return write(data.data(), data.size() * sizeof(T));
+    }
+
+    FrozenStrings write(FrontCodedStrings::Encoded const &encoded, uint32_t bucket_size) {
+        return FrozenStrings{.count = encoded.locations.size(),
+                             .bucket_size = bucket_size,
+                             .bytes_offset = write(encoded.bytes.data(), encoded.bytes.size()),
+                             .byte_count = encoded.bytes.size()};
+    }
+
+    /**
+     * @return size of the image
+     */
+    uint64_t finish(FrozenImageHeader &header) {
+        header.file_size = size_;
+        out_.seekp(0);
+        out_.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        out_.close();
+        check();
+        return size_;
+    }
+};
+
+/**
+ * Writes the live records of one node type. describe(view) returns the meta and the string to store for a record.
+ */
+template<typename SourcePolicy, typename Backend_t, typename Key_t, typename Arena_t, typename Describe_t>
+FrozenNodeTable write_table(ImageWriter &writer, DenseIDTable<SourcePolicy, Backend_t, Key_t> const &storage, Arena_t const &arena,
+                            FrozenImageOptions const &options, Describe_t const &describe, FrozenImageResult &result) {
+    struct Entry {
+        uint32_t key;
+        uint64_t hash;
+        uint64_t meta;
+        std::string_view str;
+    };
+
+    uint64_t const key_count = storage.size();
+    if (key_count > UINT32_MAX)
+        throw std::length_error("A node type of a frozen image can hold at most 2^32 - 1 IDs.");
+
+    // strings are copied, IRIs with a prefix have no contiguous view
+    std::string pool;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::vector<Entry> entries;
+    std::string buffer;
+    storage.for_each([&](NodeID id, Backend_t const &record) {
+        auto const [meta, str] = describe(record.view(arena, buffer));
+        entries.push_back(Entry{.key = static_cast<uint32_t>(Key_t::of(id) - storage.first_key()), .hash = storage.hash(id), .meta = meta, .str = {}});
+        ranges.emplace_back(pool.size(), str.size());
+        pool.append(str);
+    });
+    for (size_t i = 0; i < entries.size(); ++i)
+        entries[i].str = std::string_view{pool}.substr(ranges[i].first, ranges[i].second);
+
+    std::sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b) {
+        return a.meta != b.meta ? a.meta < b.meta : a.str < b.str;
+    });
+
+    std::vector<std::string_view> strings;
+    std::vector<uint64_t> hashes;
+    strings.reserve(entries.size());
+    hashes.reserve(entries.size());
+    for (Entry const &entry : entries) {
+        strings.push_back(entry.str);
+        hashes.push_back(entry.hash);
+    }
+    FrontCodedStrings::Encoded const encoded = FrontCodedStrings::encode(strings, options.bucket_size);
+    auto const [hash_words, slots] = MinimalPerfectHash::build(hashes);
+
+    std::vector<uint64_t> locations(key_count, FrozenNodeTable::no_location);
+    std::vector<FrozenSlot> node_slots(entries.size());
+    std::vector<FrozenRun> runs;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        locations[entries[i].key] = encoded.locations[i];
+        node_slots[slots[i]] = FrozenSlot{.location = encoded.locations[i], .key = entries[i].key};
+        if (runs.empty() || runs.back().meta != entries[i].meta)
+            runs.push_back(FrozenRun{.first_location = encoded.locations[i], .meta = entries[i].meta});
+    }
+
+    result.nodes_written += entries.size();
+    result.string_bytes_before += pool.size();
+    result.string_bytes_after += encoded.bytes.size();
+
+    return FrozenNodeTable{.first_key = storage.first_key(),
+                           .key_count = key_count,
+                           .locations_offset = writer.write(locations),
+                           .hash_offset = writer.write(hash_words),
+                           .hash_words = hash_words.size(),
+                           .slots_offset = writer.write(node_slots),
+                           .runs_offset = writer.write(runs),
+                           .run_count = runs.size(),
+                           .strings = writer.write(encoded, options.bucket_size)};
+}
+
+template<typename StoragePtr_t, typename ReverseStoragePtr_t, typename ArenaPtr_t>
+uint64_t node_type_bytes(StoragePtr_t const &storage, ReverseStoragePtr_t const &reverse_storage, ArenaPtr_t const &arena) noexcept {
+    return storage->bytes_used() + reverse_storage->bytes() + arena->bytes_used();
+}
+
+template<StoragePolicy Policy>
+FrozenImageResult export_frozen_image(BasicNodeStore<Policy> const &source, char const *path, FrozenImageOptions const &options) {
+    if (options.bucket_size == 0)
+        throw std::invalid_argument("The bucket size of a frozen image must be at least 1.");
+
+    FrozenImageResult result;
+    result.source_bytes = node_type_bytes(source.literal_storage, source.literal_storage_reverse, source.literal_arena) +
+                          node_type_bytes(source.bnode_storage, source.bnode_storage_reverse, source.bnode_arena) +
+                          node_type_bytes(source.iri_storage, source.iri_storage_reverse, source.iri_arena) +
+                          node_type_bytes(source.variable_storage, source.variable_storage_reverse, source.variable_arena);
+
+    ImageWriter writer{path};
+    FrozenImageHeader header;
+    for (size_t i = 0; i < InlinedLiteral::datatype_count; ++i)
+        header.inlined_datatype_ids[i] = source.inlined_datatype_ids[i].value();
+
+    // the image has its own tag ids, in order of first use
+    std::vector<std::string_view> language_tags{""};
+    std::unordered_map<std::string_view, uint64_t> language_tag_ids{{"", 0}};
+    header.literal = write_table(writer, *source.literal_storage, *source.literal_arena, options,
+                                 [&](view::LiteralBackendView const &view) {
+                                     auto const [it, added] = language_tag_ids.try_emplace(view.language_tag, language_tags.size());
+                                     if (added)
+                                         language_tags.push_back(view.language_tag);
+                                     return std::pair{view.datatype_id.value() | (it->second << 48), view.lexical_form};
+                                 },
+                                 result);
+    header.bnode = write_table(writer, *source.bnode_storage, *source.bnode_arena, options,
+                               [](view::BNodeBackendView const &view) { return std::pair{uint64_t{0}, view.identifier}; },
+                               result);
+    header.iri = write_table(writer, *source.iri_storage, *source.iri_arena, options,
+                             [](view::IRIBackendView const &view) { return std::pair{uint64_t{0}, view.identifier}; },
+                             result);
+    header.variable = write_table(writer, *source.variable_storage, *source.variable_arena, options,
+                                  [](view::VariableBackendView const &view) { return std::pair{uint64_t{view.is_anonymous}, view.name}; },
+                                  result);
+    FrontCodedStrings::Encoded const encoded_language_tags = FrontCodedStrings::encode(language_tags, 1);
+    header.language_tags = writer.write(encoded_language_tags, 1);
+    header.language_tag_locations_offset = writer.write(encoded_language_tags.locations);
+
+    result.image_bytes = writer.finish(header);
+    return result;
+}
+
+template FrozenImageResult export_frozen_image(MetallNodeStore const &, char const *, FrozenImageOptions const &);
+template FrozenImageResult export_frozen_image(BasicNodeStore<HeapPolicy> const &, char const *, FrozenImageOptions const &);
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -0,0 +1,143 @@
+#ifndef METALL_FROZENIMAGE_HPP
+#define METALL_FROZENIMAGE_HPP
+
+#include "InlinedLiteral.hpp"
+#include "MetallNodeStore.hpp"
+#include "StoragePolicy.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * FrontCodedStrings stored in a frozen image.
+ */
+struct FrozenStrings {
+    uint64_t count = 0;
+    uint32_t bucket_size = 1;
+    uint32_t reserved = 0;
+    uint64_t bytes_offset = 0;
+    uint64_t byte_count = 0;
+};
+
+/**
+ * Nodes at locations [first_location, next run's first_location) share meta: datatype NodeID and language tag of literals,
+ * the anonymous flag of variables. IRIs and blank nodes have a single run with meta 0.
+ */
+struct FrozenRun {
+    uint64_t first_location = 0;
+    uint64_t meta = 0;
+};
+
+/**
+ * Node in a slot of the MinimalPerfectHash of a FrozenNodeTable, so that a reverse lookup reads the slot and the string only.
+ */
+struct FrozenSlot {
+    uint64_t location = 0;
+    uint64_t key = 0;
+};
+
+struct FrozenNodeTable {
+    static constexpr uint64_t no_location = UINT64_MAX;
+
+    /**
+     * Position in the source store's DenseIDTable of the smallest key, see NodeIDKey and LiteralIDKey.
+     */
+    uint64_t first_key = 0;
+    /**
+     * One past the largest stored key, minus first_key.
+     */
+    uint64_t key_count = 0;
+    /**
+     * Forward lookup: uint64_t[key_count], the FrontCodedStrings location of every key or no_location for gaps and erased nodes.
+     */
+    uint64_t locations_offset = 0;
+    /**
+     * Reverse lookup: the MinimalPerfectHash over the ViewHash of every node, hash_words uint64_t long,
+     * and FrozenSlot[strings.count] with the location and key - first_key of the node in every hash slot.
+     */
+    uint64_t hash_offset = 0;
+    uint64_t hash_words = 0;
+    uint64_t slots_offset = 0;
+    /**
+     * FrozenRun[run_count].
+     */
+    uint64_t runs_offset = 0;
+    uint64_t run_count = 0;
+    FrozenStrings strings;
+};
+
+/**
+ * Layout of a frozen image, an immutable and compact copy of a node store that FrozenNodeStorageBackend maps read-only.
+ * All offsets are in bytes from the start of the file and 8-byte aligned. Integers are in native byte order,
+ * so like a Metall datastore an image is only portable between machines of the same endianness.
+ *
+ * Every node type is a FrozenNodeTable. Its strings are sorted by (meta, string) and front-coded in that order,
+ * see FrontCodedStrings. Both lookups reach a string's bucket through its location without further tables.
+ * The NodeIDs stay the same as in the source store.
+ */
+struct FrozenImageHeader {
+    static constexpr uint64_t magic = 0x4e5a4f52464c544dULL;  // "MTLFROZN"
+    /**
+     * Must be bumped whenever the layout of the image changes.
+     */
+    static constexpr uint32_t format_version = 1;
+
+    uint64_t magic_ = magic;
+    uint32_t format_version_ = format_version;
+    uint32_t reserved = 0;
+    uint64_t file_size = 0;
+    /**
+     * Values of the IRI NodeIDs of the InlinedLiteral datatypes in the source store.
+     */
+    std::array<uint64_t, InlinedLiteral::datatype_count> inlined_datatype_ids{};
+
+    FrozenNodeTable literal;
+    FrozenNodeTable bnode;
+    FrozenNodeTable iri;
+    FrozenNodeTable variable;
+    /**
+     * Indexed by the tag id in the meta of literal runs. Id 0 is the empty tag.
+     * language_tag_locations_offset points to uint64_t[language_tags.count], the location of every tag.
+     */
+    FrozenStrings language_tags;
+    uint64_t language_tag_locations_offset = 0;
+};
+
+struct FrozenImageOptions {
+    /**
+     * Strings per front-coded bucket. Larger buckets make the image smaller, a lookup reads the first string
+     * of the bucket and the string itself whatever the size.
+     * 1 stores every string whole so that no view has to be decoded.
+     */
+    uint32_t bucket_size = 16;
+};
+
+struct FrozenImageResult {
+    uint64_t nodes_written = 0;
+    /**
+     * Bytes in use by the forward tables, reverse indexes and arenas of the source store.
+     */
+    uint64_t source_bytes = 0;
+    uint64_t image_bytes = 0;
+    /**
+     * Bytes of all node strings, before and after front coding.
+     */
+    uint64_t string_bytes_before = 0;
+    uint64_t string_bytes_after = 0;
+};
+
+/**
+ * Writes all nodes of source that were not erased as a frozen image to path, replacing the file if it exists.
+ * Nodes keep their IDs. Inlined literals are not stored, like in the source.
+ * source may be read concurrently, but not written, see DenseIDTable::for_each. BasicNodeStorageBackend::export_frozen_image pauses its writers.
+ * @throws std::invalid_argument if options.bucket_size is 0
+ * @throws std::length_error if a node type has 2^32 or more IDs or 2^40 or more bytes of strings, which the image cannot address
+ * @throws std::runtime_error if the file cannot be written
+ */
+template<StoragePolicy Policy>
+FrozenImageResult export_frozen_image(BasicNodeStore<Policy> const &source, char const *path, FrozenImageOptions const &options = {});
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_FROZENIMAGE_HPP
@@ -0,0 +1,256 @@
+#include "FrozenNodeStorageBackend.hpp"
+
+#include "ViewHash.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+static constexpr uint64_t datatype_mask = (uint64_t{1} << 48) - 1;
+
+/**
+ * @return count objects of type T at offset in the mapping
+ * @throws std::runtime_error if they do not fit into the mapping
+ */
+template<typename T>
+static T const *section(void const *address, size_t size, uint64_t offset, uint64_t count) {
+    if (offset % alignof(T) != 0 || offset > size || count > (size - offset) / sizeof(T))
+        throw std::runtime_error("The frozen image is truncated.");
+    return reinterpret_cast<T const *>(static_cast<char const *>(address) + offset);
+}
+
+static FrontCodedStrings open_strings(void const *address, size_t size, FrozenStrings const &layout) {
+    if (layout.bucket_size == 0)
+        throw std::runtime_error("The frozen image is corrupt.");
+    return FrontCodedStrings{section<char>(address, size, layout.bytes_offset, layout.byte_count)};
+}
+
+FrozenNodeStorageBackend::FrozenNodeStorageBackend(char const *path) : INodeStorageBackend() {
+    int const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Could not open the frozen image " + std::string{path} + ".");
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(FrozenImageHeader)) {
+        ::close(fd);
+        throw std::runtime_error(std::string{path} + " is not a frozen image.");
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    void *const address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Could not map the frozen image " + std::string{path} + ".");
+    address_ = address;
+
+    try {
+        header_ = static_cast<FrozenImageHeader const *>(address_);
+        if (header_->magic_ != FrozenImageHeader::magic)
+            throw std::runtime_error(std::string{path} + " is not a frozen image.");
+        if (header_->format_version_ != FrozenImageHeader::format_version)
+            throw std::runtime_error("Frozen image format version " + std::to_string(header_->format_version_) +
+                                     " is not supported, expected version " + std::to_string(FrozenImageHeader::format_version) + ".");
+        if (header_->file_size != size_)
+            throw std::runtime_error("The frozen image is truncated.");
+
+        open_table(literals_, header_->literal);
+        open_table(bnodes_, header_->bnode);
+        open_table(iris_, header_->iri);
+        open_table(variables_, header_->variable);
+        language_tags_ = open_strings(address_, size_, header_->language_tags);
+        language_tag_locations_ = section<uint64_t>(address_, size_, header_->language_tag_locations_offset, header_->language_tags.count);
+        for (size_t i = 0; i < InlinedLiteral::datatype_count; ++i)
+            inlined_datatype_ids_[i] = NodeID{header_->inlined_datatype_ids[i]};
+    } catch (...) {
+        ::munmap(address, size_);
+        throw;
+    }
+}
+
+FrozenNodeStorageBackend::FrozenNodeStorageBackend(char const *path, MappingOptions const &options)
+    : FrozenNodeStorageBackend(path) {
+    advise(options);
+}
+
+FrozenNodeStorageBackend::~FrozenNodeStorageBackend() {
+    ::munmap(const_cast<void *>(address_), size_);
+}
+
+void FrozenNodeStorageBackend::open_table(Table &table, FrozenNodeTable const &layout) const {
+    table.layout = &layout;
+    table.locations = section<uint64_t>(address_, size_, layout.locations_offset, layout.key_count);
+    table.hash = MinimalPerfectHash{std::span<uint64_t const>{section<uint64_t>(address_, size_, layout.hash_offset, layout.hash_words), layout.hash_words}};
+    table.slots = section<FrozenSlot>(address_, size_, layout.slots_offset, layout.strings.count);
+    table.runs = section<FrozenRun>(address_, size_, layout.runs_offset, layout.run_count);
+    table.strings = open_strings(address_, size_, layout.strings);
+    if (table.hash.size() != layout.strings.count)
+        throw std::runtime_error("The frozen image is corrupt.");
+}
+
+bool FrozenNodeStorageBackend::advise(MappingOptions const &options) const {
+    bool ok = advise_mapping(address_, size_, options);
+    // the image is a regular file, whose page cache ignores memory policies
+    return ok && !options.interleave_index;
+}
+
+std::optional<uint64_t> FrozenNodeStorageBackend::location_of(Table const &table, uint64_t key) noexcept {
+    if (key < table.layout->first_key || key - table.layout->first_key >= table.layout->key_count)
+        return std::nullopt;
+    uint64_t const location = table.locations[key - table.layout->first_key];
+    if (location == FrozenNodeTable::no_location)
+        return std::nullopt;
+    return location;
+}
+
+uint64_t FrozenNodeStorageBackend::checked_location(Table const &table, uint64_t key) {
+    auto const location = location_of(table, key);
+    if (!location.has_value())
+        throw std::out_of_range("No node stored for the given NodeID.");
+    return *location;
+}
+
+uint64_t FrozenNodeStorageBackend::meta_of(Table const &table, uint64_t location) noexcept {
+    uint64_t const run_count = table.layout->run_count;
+    if (run_count <= 1)
+        return run_count == 0 ? 0 : table.runs[0].meta;
+    FrozenRun const *const next = std::upper_bound(table.runs, table.runs + run_count, location, [](uint64_t l, FrozenRun const &run) {
+        return l < run.first_location;
+    });
+    return next[-1].meta;
+}
+
+template<typename Matches_t>
+std::optional<uint64_t> FrozenNodeStorageBackend::find_key(Table const &table, uint64_t hash, std::string_view str,
+                                                           Matches_t const &matches) noexcept {
+    auto const [first, last] = table.hash.find(hash);
+    for (uint64_t slot = first; slot < last; ++slot) {
+        FrozenSlot const &node = table.slots[slot];
+        if (matches(meta_of(table, node.location)) && table.strings.equals(node.location, str))
+            return table.layout->first_key + node.key;
+    }
+    return std::nullopt;
+}
+
+std::string_view FrozenNodeStorageBackend::stable_string(Table const &table, uint64_t location) {
+    if (FrontCodedStrings::contiguous(location)) {
+        std::string unused;
+        return table.strings.get(location, unused);
+    }
+    return table.decoded.find_or_decode(location, [&](std::string &buffer) {
+        return table.strings.get(location, buffer);
+    });
+}
+
+std::string_view FrozenNodeStorageBackend::language_tag(uint64_t id) const noexcept {
+    // every tag is stored whole, the buffer is not used
+    std::string unused;
+    return language_tags_.get(language_tag_locations_[id], unused);
+}
+
+view::LiteralBackendView FrozenNodeStorageBackend::literal_view(uint64_t location, std::string_view lexical_form) const noexcept {
+    uint64_t const meta = meta_of(literals_, location);
+    return {.datatype_id = NodeID{meta & datatype_mask},
+            .lexical_form = lexical_form,
+            .language_tag = language_tag(meta >> 48)};
+}
+
+identifier::NodeID FrozenNodeStorageBackend::find_or_make_id(view::BNodeBackendView const &view) noexcept {
+    return find_id(view);
+}
+identifier::NodeID FrozenNodeStorageBackend::find_or_make_id(view::IRIBackendView const &view) noexcept {
+    return find_id(view);
+}
+identifier::NodeID FrozenNodeStorageBackend::find_or_make_id(view::LiteralBackendView const &view) noexcept {
+    return find_id(view);
+}
+identifier::NodeID FrozenNodeStorageBackend::find_or_make_id(view::VariableBackendView const &view) noexcept {
+    return find_id(view);
+}
+
+identifier::NodeID FrozenNodeStorageBackend::find_id(view::BNodeBackendView const &view) const noexcept {
+    auto const key = find_key(bnodes_, ViewHash{}(view), view.identifier, [](uint64_t) { return true; });
+    return key.has_value() ? NodeIDKey::id(*key) : NodeID{};
+}
+identifier::NodeID FrozenNodeStorageBackend::find_id(view::IRIBackendView const &view) const noexcept {
+    auto const key = find_key(iris_, ViewHash{}(view), view.identifier, [](uint64_t) { return true; });
+    return key.has_value() ? NodeIDKey::id(*key) : NodeID{};
+}
+identifier::NodeID FrozenNodeStorageBackend::find_id(view::LiteralBackendView const &view) const noexcept {
+    if (NodeID const inlined = InlinedLiteral::id_of(inlined_datatype_ids_, view); !inlined.null())
+        return inlined;
+    auto const key = find_key(literals_, ViewHash{}(view), view.lexical_form, [&](uint64_t meta) {
+        return (meta & datatype_mask) == view.datatype_id.value() && language_tag(meta >> 48) == view.language_tag;
+    });
+    return key.has_value() ? LiteralIDKey::id(*key) : NodeID{};
+}
+identifier::NodeID FrozenNodeStorageBackend::find_id(view::VariableBackendView const &view) const noexcept {
+    auto const key = find_key(variables_, ViewHash{}(view), view.name, [&](uint64_t meta) {
+        return meta == static_cast<uint64_t>(view.is_anonymous);
+    });
+    return key.has_value() ? NodeIDKey::id(*key) : NodeID{};
+}
+
+view::IRIBackendView FrozenNodeStorageBackend::find_iri_backend_view(identifier::NodeID id) const {
+    return {.identifier = stable_string(iris_, checked_location(iris_, NodeIDKey::of(id)))};
+}
+view::LiteralBackendView FrozenNodeStorageBackend::find_literal_backend_view(identifier::NodeID id) const {
+    if (auto const datatype = InlinedLiteral::datatype_of(id.literal_type()); datatype.has_value()) {
+        return {.datatype_id = inlined_datatype_ids_[InlinedLiteral::index_of(*datatype)],
+                .lexical_form = decoded_inlined_.find_or_decode(id.value(), [&](std::string &buffer) -> std::string_view {
+                    buffer = InlinedLiteral::decode(*datatype, id.literal_id().value);
+                    return buffer;
+                }),
+                .language_tag = ""};
+    }
+    uint64_t const location = checked_location(literals_, LiteralIDKey::of(id));
+    return literal_view(location, stable_string(literals_, location));
+}
+view::BNodeBackendView FrozenNodeStorageBackend::find_bnode_backend_view(identifier::NodeID id) const {
+    return {.identifier = stable_string(bnodes_, checked_location(bnodes_, NodeIDKey::of(id)))};
+}
+view::VariableBackendView FrozenNodeStorageBackend::find_variable_backend_view(identifier::NodeID id) const {
+    uint64_t const location = checked_location(variables_, NodeIDKey::of(id));
+    return {.name = stable_string(variables_, location),
+            .is_anonymous = meta_of(variables_, location) != 0};
+}
+
+view::IRIBackendView FrozenNodeStorageBackend::find_iri_backend_view(identifier::NodeID id, std::string &buffer) const {
+    return {.identifier = iris_.strings.get(checked_location(iris_, NodeIDKey::of(id)), buffer)};
+}
+view::LiteralBackendView FrozenNodeStorageBackend::find_literal_backend_view(identifier::NodeID id, std::string &buffer) const {
+    if (auto const datatype = InlinedLiteral::datatype_of(id.literal_type()); datatype.has_value()) {
+        buffer = InlinedLiteral::decode(*datatype, id.literal_id().value);
+        return {.datatype_id = inlined_datatype_ids_[InlinedLiteral::index_of(*datatype)],
+                .lexical_form = buffer,
+                .language_tag = ""};
+    }
+    uint64_t const location = checked_location(literals_, LiteralIDKey::of(id));
+    return literal_view(location, literals_.strings.get(location, buffer));
+}
+view::BNodeBackendView FrozenNodeStorageBackend::find_bnode_backend_view(identifier::NodeID id, std::string &buffer) const {
+    return {.identifier = bnodes_.strings.get(checked_location(bnodes_, NodeIDKey::of(id)), buffer)};
+}
+view::VariableBackendView FrozenNodeStorageBackend::find_variable_backend_view(identifier::NodeID id, std::string &buffer) const {
+    uint64_t const location = checked_location(variables_, NodeIDKey::of(id));
+    return {.name = variables_.strings.get(location, buffer),
+            .is_anonymous = meta_of(variables_, location) != 0};
+}
+
+bool FrozenNodeStorageBackend::erase_iri(identifier::NodeID) const {
+    throw std::runtime_error("A frozen image is read-only.");
+}
+bool FrozenNodeStorageBackend::erase_literal(identifier::NodeID) const {
+    throw std::runtime_error("A frozen image is read-only.");
+}
+bool FrozenNodeStorageBackend::erase_bnode(identifier::NodeID) const {
+    throw std::runtime_error("A frozen image is read-only.");
+}
+bool FrozenNodeStorageBackend::erase_variable(identifier::NodeID) const {
+    throw std::runtime_error("A frozen image is read-only.");
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
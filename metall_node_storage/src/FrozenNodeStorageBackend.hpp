@@ -0,0 +1,183 @@
+#ifndef METALL_FROZENNODESTORAGEBACKEND_HPP
+#define METALL_FROZENNODESTORAGEBACKEND_HPP
+
+#include <rdf4cpp/rdf/storage/node/INodeStorageBackend.hpp>
+
+#include "DecodedStrings.hpp"
+#include "FrontCodedStrings.hpp"
+#include "FrozenImage.hpp"
+#include "InlinedLiteral.hpp"
+#include "MappingOptions.hpp"
+#include "MinimalPerfectHash.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Read-only INodeStorageBackend over a frozen image written by export_frozen_image, for datasets that are served unchanged.
+ * The image is mapped directly, attaching costs one mmap and nothing is rebuilt. The NodeIDs are the ones of the exported store.
+ * Thread-safe, nothing is locked.
+ *
+ * find_id hashes the view once, finds its slot in a MinimalPerfectHash and compares the single candidate without decoding it.
+ * find_*_backend_view looks up the location of the id in a dense array and reads the front-coded string there.
+ * Either way the string's bucket is the only other memory touched.
+ * Strings that start a bucket are viewed in the mapping. The others and inlined literals are decoded once into the DecodedStrings
+ * of the backend, like prefix-compressed IRIs in BasicNodeStorageBackend, and stay valid as long as the backend exists.
+ *
+ * The image is immutable. find_or_make_id only finds, it returns the null NodeID for nodes that are not in the image,
+ * like BasicNodeStorageBackend over a read-only datastore. erase throws.
+ */
+class FrozenNodeStorageBackend : public INodeStorageBackend {
+public:
+    using NodeID = identifier::NodeID;
+
+private:
+    /**
+     * One node type of the image, resolved to addresses in the mapping.
+     */
+    struct Table {
+        FrozenNodeTable const *layout = nullptr;
+        uint64_t const *locations = nullptr;
+        FrozenSlot const *slots = nullptr;
+        FrozenRun const *runs = nullptr;
+        MinimalPerfectHash hash;
+        FrontCodedStrings strings;
+        /**
+         * Strings that do not start a bucket, by location.
+         */
+        mutable DecodedStrings decoded;
+    };
+
+    void const *address_ = nullptr;
+    size_t size_ = 0;
+    FrozenImageHeader const *header_ = nullptr;
+
+    Table literals_;
+    Table bnodes_;
+    Table iris_;
+    Table variables_;
+    FrontCodedStrings language_tags_;
+    uint64_t const *language_tag_locations_ = nullptr;
+    std::array<NodeID, InlinedLiteral::datatype_count> inlined_datatype_ids_{};
+    /**
+     * Lexical forms of inlined literals, by NodeID.
+     */
+    mutable DecodedStrings decoded_inlined_;
+
+    void open_table(Table &table, FrozenNodeTable const &layout) const;
+
+    /**
+     * @return location of the node with key, or nothing if it is not stored
+     */
+    [[nodiscard]] static std::optional<uint64_t> location_of(Table const &table, uint64_t key) noexcept;
+    /**
+     * @throws std::out_of_range if there is no node with key
+     */
+    [[nodiscard]] static uint64_t checked_location(Table const &table, uint64_t key);
+    [[nodiscard]] static uint64_t meta_of(Table const &table, uint64_t location) noexcept;
+
+    /**
+     * @param matches called as matches(meta) for a candidate with the right hash, before its string is compared
+     * @return key of the node with str, or nothing
+     */
+    template<typename Matches_t>
+    [[nodiscard]] static std::optional<uint64_t> find_key(Table const &table, uint64_t hash, std::string_view str,
+                                                          Matches_t const &matches) noexcept;
+
+    /**
+     * @return the string at location, in the mapping if it starts a bucket and in table.decoded otherwise
+     */
+    [[nodiscard]] static std::string_view stable_string(Table const &table, uint64_t location);
+    [[nodiscard]] std::string_view language_tag(uint64_t id) const noexcept;
+    [[nodiscard]] view::LiteralBackendView literal_view(uint64_t location, std::string_view lexical_form) const noexcept;
+
+public:
+    /**
+     * Maps the frozen image at path read-only.
+     * @throws std::runtime_error if the file cannot be mapped, is no frozen image, has another format version or is truncated
+     */
+    explicit FrozenNodeStorageBackend(char const *path);
+
+    /**
+     * Maps like the constructor above and applies options with advise.
+     */
+    FrozenNodeStorageBackend(char const *path, MappingOptions const &options);
+
+    ~FrozenNodeStorageBackend() override;
+
+    FrozenNodeStorageBackend(FrozenNodeStorageBackend const &) = delete;
+    FrozenNodeStorageBackend &operator=(FrozenNodeStorageBackend const &) = delete;
+
+    /**
+     * Applies placement hints to the mapping of the image, see MappingOptions.
+     * interleave_index has no effect on the file mapping of an image and makes this return false, see interleave_numa.
+     * @return false if the kernel rejected any of the hints
+     */
+    bool advise(MappingOptions const &options) const;
+
+    /**
+     * Size of the mapped image in bytes.
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    /**
+     * Stored nodes per node type. Inlined literals are not stored and not counted.
+     */
+    [[nodiscard]] uint64_t literal_count() const noexcept {
+        return literals_.layout->strings.count;
+    }
+    [[nodiscard]] uint64_t bnode_count() const noexcept {
+        return bnodes_.layout->strings.count;
+    }
+    [[nodiscard]] uint64_t iri_count() const noexcept {
+        return iris_.layout->strings.count;
+    }
+    [[nodiscard]] uint64_t variable_count() const noexcept {
+        return variables_.layout->strings.count;
+    }
+
+    /**
+     * Same as find_id, nothing is added to the immutable image.
+     * @return the null NodeID if the node is not in the image
+     */
+    [[nodiscard]] identifier::NodeID find_or_make_id(view::BNodeBackendView const &) noexcept override;
+    [[nodiscard]] identifier::NodeID find_or_make_id(view::IRIBackendView const &) noexcept override;
+    [[nodiscard]] identifier::NodeID find_or_make_id(view::LiteralBackendView const &) noexcept override;
+    [[nodiscard]] identifier::NodeID find_or_make_id(view::VariableBackendView const &) noexcept override;
+
+    [[nodiscard]] identifier::NodeID find_id(view::BNodeBackendView const &) const noexcept override;
+    [[nodiscard]] identifier::NodeID find_id(view::IRIBackendView const &) const noexcept override;
+    [[nodiscard]] identifier::NodeID find_id(view::LiteralBackendView const &) const noexcept override;
+    [[nodiscard]] identifier::NodeID find_id(view::VariableBackendView const &) const noexcept override;
+
+    [[nodiscard]] view::IRIBackendView find_iri_backend_view(identifier::NodeID id) const override;
+    [[nodiscard]] view::LiteralBackendView find_literal_backend_view(identifier::NodeID id) const override;
+    [[nodiscard]] view::BNodeBackendView find_bnode_backend_view(identifier::NodeID id) const override;
+    [[nodiscard]] view::VariableBackendView find_variable_backend_view(identifier::NodeID id) const override;
+
+    /**
+     * Decode into buffer instead of keeping a copy in the backend. The views are valid until buffer is modified.
+     */
+    [[nodiscard]] view::IRIBackendView find_iri_backend_view(identifier::NodeID id, std::string &buffer) const;
+    [[nodiscard]] view::LiteralBackendView find_literal_backend_view(identifier::NodeID id, std::string &buffer) const;
+    [[nodiscard]] view::BNodeBackendView find_bnode_backend_view(identifier::NodeID id, std::string &buffer) const;
+    [[nodiscard]] view::VariableBackendView find_variable_backend_view(identifier::NodeID id, std::string &buffer) const;
+
+    /**
+     * @throws std::runtime_error always, a frozen image is read-only
+     */
+    bool erase_iri(identifier::NodeID id) const override;
+    bool erase_literal(identifier::NodeID id) const override;
+    bool erase_bnode(identifier::NodeID id) const override;
+    bool erase_variable(identifier::NodeID id) const override;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_FROZENNODESTORAGEBACKEND_HPP
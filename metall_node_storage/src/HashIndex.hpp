@@ -0,0 +1,221 @@
+#ifndef METALL_HASHINDEX_HPP
+#define METALL_HASHINDEX_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include "StoragePolicy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Persistent open-addressing hash table for reverse lookups view -> NodeID.
+ * A slot keeps only the 64-bit hash of the record and its NodeID. The record itself is resolved through the forward table,
+ * and only when the hashes match.
+ * Uses linear probing over a power-of-two table. Erasing shifts the following entries back, so no tombstones are left in the table.
+ * Not thread-safe, callers must synchronize.
+ */
+template<StoragePolicy Policy>
+class HashIndex {
+public:
+    using NodeID = identifier::NodeID;
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+    struct Slot {
+        uint64_t hash = 0;
+        NodeID id{};
+
+        [[nodiscard]] bool empty() const noexcept {
+            return id.null();
+        }
+    };
+
+    static constexpr size_t min_capacity = 1024;
+
+private:
+    typename Policy::template vector<Slot> slots_;
+    size_t size_ = 0;
+
+    [[nodiscard]] size_t mask() const noexcept {
+        return slots_.size() - 1;
+    }
+
+    /**
+     * Grow once the table is 3/4 full. Beyond that, linear probing degrades quickly.
+     */
+    [[nodiscard]] bool needs_growth(size_t new_size) const noexcept {
+        return new_size * 4 > slots_.size() * 3;
+    }
+
+    void place(Slot const &slot) noexcept {
+        for (size_t pos = slot.hash & mask();; pos = (pos + 1) & mask()) {
+            if (slots_[pos].empty()) {
+                slots_[pos] = slot;
+                return;
+            }
+        }
+    }
+
+    void rehash(size_t new_capacity) {
+        decltype(slots_) old{new_capacity, slots_.get_allocator()};
+        old.swap(slots_);
+        for (auto const &slot : old) {
+            if (!slot.empty())
+                place(slot);
+        }
+    }
+
+public:
+    explicit HashIndex(Alloc const &alloc, size_t initial_capacity = min_capacity)
+        : slots_(std::bit_ceil(std::max(initial_capacity, min_capacity)), alloc) {}
+
+    /**
+     * @param equal called as equal(NodeID) for candidates with a matching hash
+     * @return the matching NodeID, or the null NodeID if there is none
+     */
+    template<typename Equal_t>
+    [[nodiscard]] NodeID find(uint64_t hash, Equal_t const &equal) const noexcept {
+        for (size_t pos = hash & mask();; pos = (pos + 1) & mask()) {
+            Slot const &slot = slots_[pos];
+            if (slot.empty())
+                return {};
+            if (slot.hash == hash && equal(slot.id))
+                return slot.id;
+        }
+    }
+
+    /**
+     * Inserts a record. The record must not be contained yet.
+     */
+    void insert(uint64_t hash, NodeID id) {
+        if (needs_growth(size_ + 1))
+            rehash(slots_.size() * 2);
+        place(Slot{.hash = hash, .id = id});
+        ++size_;
+    }
+
+    /**
+     * Removes the entry for id.
+     * @return false if there is no such entry
+     */
+    bool erase(uint64_t hash, NodeID id) noexcept {
+        size_t pos = hash & mask();
+        for (;; pos = (pos + 1) & mask()) {
+            if (slots_[pos].empty())
+                return false;
+            if (slots_[pos].id == id)
+                break;
+        }
+
+        // backward-shift deletion: move every following entry of the probe run into the hole, unless that would place it before its home slot
+        for (size_t next = (pos + 1) & mask();; next = (next + 1) & mask()) {
+            if (slots_[next].empty())
+                break;
+            size_t const home = slots_[next].hash & mask();
+            if (((next - home) & mask()) >= ((next - pos) & mask())) {
+                slots_[pos] = slots_[next];
+                pos = next;
+            }
+        }
+        slots_[pos] = Slot{};
+        --size_;
+        return true;
+    }
+
+    /**
+     * Grows the table so that n entries fit without further rehashing.
+     */
+    void reserve(size_t n) {
+        size_t capacity = slots_.size();
+        while (n * 4 > capacity * 3)
+            capacity *= 2;
+        if (capacity != slots_.size())
+            rehash(capacity);
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return slots_.size();
+    }
+
+    [[nodiscard]] double load_factor() const noexcept {
+        return static_cast<double>(size_) / static_cast<double>(slots_.size());
+    }
+
+    [[nodiscard]] uint64_t bytes() const noexcept {
+        return slots_.size() * sizeof(Slot);
+    }
+
+    /**
+     * Address of the slots, bytes() long. Changes when the table grows.
+     */
+    [[nodiscard]] void const *data() const noexcept {
+        return &slots_.front();
+    }
+};
+
+/**
+ * Reverse index split into 2^stripe_bits independent HashIndexes, so that inserts into different stripes can run in parallel.
+ * The stripe is selected by the upper bits of the hash, the position inside a stripe by the lower bits.
+ * Each stripe must be synchronized separately by the caller.
+ */
+template<StoragePolicy Policy>
+class StripedHashIndex {
+public:
+    using Alloc = typename HashIndex<Policy>::Alloc;
+
+    static constexpr unsigned default_stripe_bits = 6;
+
+private:
+    typename Policy::template vector<HashIndex<Policy>> stripes_;
+    unsigned stripe_bits_;
+
+public:
+    explicit StripedHashIndex(Alloc const &alloc, unsigned stripe_bits = default_stripe_bits)
+        : stripes_(alloc), stripe_bits_(stripe_bits) {
+        stripes_.reserve(size_t{1} << stripe_bits);
+        for (size_t i = 0; i < (size_t{1} << stripe_bits); ++i)
+            stripes_.emplace_back(alloc);
+    }
+
+    [[nodiscard]] size_t stripe_of(uint64_t hash) const noexcept {
+        return stripe_bits_ == 0 ? 0 : static_cast<size_t>(hash >> (64 - stripe_bits_));
+    }
+
+    [[nodiscard]] size_t stripe_count() const noexcept {
+        return stripes_.size();
+    }
+
+    [[nodiscard]] HashIndex<Policy> &stripe(size_t i) noexcept {
+        return stripes_[i];
+    }
+
+    [[nodiscard]] HashIndex<Policy> const &stripe(size_t i) const noexcept {
+        return stripes_[i];
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        size_t n = 0;
+        for (auto const &stripe : stripes_)
+            n += stripe.size();
+        return n;
+    }
+    /**
+     * Bytes of the slots of all stripes. Like size, only exact while no stripe is modified.
+     */
+    [[nodiscard]] uint64_t bytes() const noexcept {
+        uint64_t n = 0;
+        for (auto const &stripe : stripes_)
+            n += stripe.bytes();
+        return n;
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_HASHINDEX_HPP
@@ -1,40 +1,76 @@
 #ifndef METALL_IRIBACKEND_HPP
 #define METALL_IRIBACKEND_HPP
 
-#include <metall/metall.hpp>
-
 #include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
 #include <rdf4cpp/rdf/storage/node/view/IRIBackendView.hpp>
 
+#include "PrefixedStringArena.hpp"
+
 #include <compare>
-#include <memory>
 #include <string>
 #include <string_view>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
-
+/**
+ * Stored IRI. The identifier lives in a PrefixedStringArena as a shared namespace prefix and a suffix,
+ * the record only keeps their positions. It is not contiguous, so views are rebuilt into a caller-provided buffer.
+ */
 class IRIBackend {
-    std::string iri;
+    PrefixedStringRef iri;
 
 public:
-    explicit IRIBackend(std::string_view iri) noexcept;
-    explicit IRIBackend(view::IRIBackendView view) noexcept;
-    auto operator<=>(const IRIBackend &) const = default;
-    auto operator<=>(view::IRIBackendView const &other) const noexcept {
-        return view::IRIBackendView(*this) <=> other;
+    IRIBackend() noexcept = default;
+    template<StoragePolicy Policy>
+    IRIBackend(PrefixedStringArena<Policy> &arena, std::string_view iri) : iri(arena.append(iri)) {}
+    template<StoragePolicy Policy>
+    IRIBackend(PrefixedStringArena<Policy> &arena, view::IRIBackendView view) : iri(arena.append(view.identifier)) {}
+
+    /**
+     * @return true for the gaps in a DenseIDTable that do not hold an IRI
+     */
+    [[nodiscard]] bool null() const noexcept {
+        return iri.null();
+    }
+
+    /**
+     * @return true if the IRI is stored without a prefix, so that identifier needs no buffer
+     */
+    [[nodiscard]] bool contiguous() const noexcept {
+        return iri.prefix_id == 0;
+    }
+
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string_view identifier(PrefixedStringArena<Policy> const &arena, std::string &buffer) const {
+        return arena.view(iri, buffer);
+    }
+
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::IRIBackendView view(PrefixedStringArena<Policy> const &arena, std::string &buffer) const {
+        return {.identifier = identifier(arena, buffer)};
     }
-    std::partial_ordering operator<=>(metall::offset_ptr<IRIBackend> const &other) const noexcept;
 
-    [[nodiscard]] std::string_view identifier() const noexcept;
+    template<StoragePolicy Policy>
+    [[nodiscard]] bool equals(PrefixedStringArena<Policy> const &arena, view::IRIBackendView const &view) const noexcept {
+        return arena.equals(iri, view.identifier);
+    }
 
-    explicit operator view::IRIBackendView() const noexcept;
+    /**
+     * Lexicographic order of the identifiers.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::strong_ordering compare(PrefixedStringArena<Policy> const &arena, IRIBackend const &other) const noexcept {
+        return arena.compare(iri, other.iri);
+    }
+
+    /**
+     * Order of the first length bytes of the identifier relative to str.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::strong_ordering compare(PrefixedStringArena<Policy> const &arena, std::string_view str,
+                                               size_t length = std::string_view::npos) const noexcept {
+        return arena.compare(iri, str, length);
+    }
 };
-std::partial_ordering operator<=>(metall::offset_ptr<IRIBackend> const &self, metall::offset_ptr<IRIBackend> const &other) noexcept;
 }  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
-namespace rdf4cpp::rdf::storage::node::view {
-inline std::partial_ordering operator<=>(IRIBackendView const &lhs, metall::offset_ptr<metall_node_storage::IRIBackend> const &rhs) noexcept {
-    return lhs <=> IRIBackendView(*rhs);
-}
-}  // namespace rdf4cpp::rdf::storage::node::view
 #endif  //METALL_IRIBACKEND_HPP
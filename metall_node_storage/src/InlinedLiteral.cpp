@@ -0,0 +1,146 @@
+#include "InlinedLiteral.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <limits>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+namespace {
+constexpr int64_t integer_bias = int64_t{1} << (InlinedLiteral::payload_bits - 1);
+constexpr int64_t min_integer = -integer_bias;
+constexpr int64_t max_integer = integer_bias - 1;
+
+/**
+ * Dates are counted in days from 0001-01-01, the smallest date with a canonical four-digit year.
+ */
+constexpr std::chrono::sys_days min_date{std::chrono::year{1} / std::chrono::January / 1};
+
+bool is_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Canonical xsd:integer lexical form: no sign for non-negative values, no leading zeros, "0" not "-0".
+ */
+std::optional<int64_t> parse_canonical_integer(std::string_view lexical) noexcept {
+    std::string_view digits = lexical;
+    if (!digits.empty() && digits.front() == '-')
+        digits.remove_prefix(1);
+    if (digits.empty() || (digits.front() == '0' && (digits.size() > 1 || digits.size() != lexical.size())))
+        return std::nullopt;
+    for (char c : digits) {
+        if (!is_digit(c))
+            return std::nullopt;
+    }
+
+    int64_t value;
+    auto const [end, ec] = std::from_chars(lexical.data(), lexical.data() + lexical.size(), value);
+    if (ec != std::errc{} || end != lexical.data() + lexical.size())
+        return std::nullopt;
+    return value;
+}
+
+std::optional<uint64_t> encode_integer(std::string_view lexical, int64_t min, int64_t max) noexcept {
+    auto const value = parse_canonical_integer(lexical);
+    if (!value.has_value() || *value < min || *value > max)
+        return std::nullopt;
+    return static_cast<uint64_t>(*value + integer_bias);
+}
+
+/**
+ * Canonical xsd:date without timezone: YYYY-MM-DD with a four-digit year of at least 0001.
+ */
+std::optional<uint64_t> encode_date(std::string_view lexical) noexcept {
+    if (lexical.size() != 10 || lexical[4] != '-' || lexical[7] != '-')
+        return std::nullopt;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (!is_digit(lexical[i]))
+            return std::nullopt;
+    }
+    auto const number = [&](size_t pos, size_t len) {
+        unsigned value = 0;
+        for (size_t i = pos; i < pos + len; ++i)
+            value = value * 10 + static_cast<unsigned>(lexical[i] - '0');
+        return value;
+    };
+
+    std::chrono::year_month_day const date{std::chrono::year{static_cast<int>(number(0, 4))},
+                                           std::chrono::month{number(5, 2)},
+                                           std::chrono::day{number(8, 2)}};
+    if (date.year() < std::chrono::year{1} || !date.ok())
+        return std::nullopt;
+    return static_cast<uint64_t>((std::chrono::sys_days{date} - min_date).count());
+}
+
+void append_padded(std::string &out, unsigned value, size_t width) {
+    char buffer[8];
+    auto const [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(width - std::min(width, static_cast<size_t>(end - buffer)), '0');
+    out.append(buffer, end);
+}
+}  // namespace
+
+std::optional<uint64_t> InlinedLiteral::encode(InlinedDatatype datatype, std::string_view lexical) noexcept {
+    switch (datatype) {
+        case InlinedDatatype::xsd_boolean: {
+            if (lexical == "false")
+                return 0;
+            if (lexical == "true")
+                return 1;
+            return std::nullopt;
+        }
+        case InlinedDatatype::xsd_integer:
+        case InlinedDatatype::xsd_long:
+            return encode_integer(lexical, min_integer, max_integer);
+        case InlinedDatatype::xsd_int:
+            return encode_integer(lexical, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+        case InlinedDatatype::xsd_date:
+            return encode_date(lexical);
+    }
+    return std::nullopt;
+}
+
+std::string InlinedLiteral::decode(InlinedDatatype datatype, uint64_t payload) {
+    switch (datatype) {
+        case InlinedDatatype::xsd_boolean:
+            return payload == 0 ? "false" : "true";
+        case InlinedDatatype::xsd_integer:
+        case InlinedDatatype::xsd_long:
+        case InlinedDatatype::xsd_int: {
+            char buffer[24];
+            auto const [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(payload) - integer_bias);
+            return {buffer, end};
+        }
+        case InlinedDatatype::xsd_date: {
+            std::chrono::year_month_day const date{min_date + std::chrono::days{static_cast<int64_t>(payload)}};
+            std::string out;
+            out.reserve(10);
+            append_padded(out, static_cast<unsigned>(static_cast<int>(date.year())), 4);
+            out.push_back('-');
+            append_padded(out, static_cast<unsigned>(date.month()), 2);
+            out.push_back('-');
+            append_padded(out, static_cast<unsigned>(date.day()), 2);
+            return out;
+        }
+    }
+    return {};
+}
+
+identifier::NodeID InlinedLiteral::id_of(std::array<identifier::NodeID, datatype_count> const &datatype_ids,
+                                         view::LiteralBackendView const &view) noexcept {
+    if (!view.language_tag.empty())
+        return {};
+    for (size_t i = 0; i < datatype_count; ++i) {
+        if (datatype_ids[i] != view.datatype_id)
+            continue;
+        InlinedDatatype const datatype = datatype_at(i);
+        auto const payload = encode(datatype, view.lexical_form);
+        if (!payload.has_value())
+            return {};
+        return identifier::NodeID{identifier::LiteralID{*payload}, literal_type(datatype)};
+    }
+    return {};
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
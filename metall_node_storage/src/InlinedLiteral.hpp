@@ -0,0 +1,91 @@
+#ifndef METALL_INLINEDLITERAL_HPP
+#define METALL_INLINEDLITERAL_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/LiteralType.hpp>
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+#include <rdf4cpp/rdf/storage/node/view/LiteralBackendView.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Datatypes whose values are encoded directly in the NodeID instead of being stored.
+ * The value doubles as the LiteralType tag of the NodeID, 0 is LiteralType::OTHER.
+ */
+enum struct InlinedDatatype : uint8_t {
+    xsd_boolean = 1,
+    xsd_integer,
+    xsd_long,
+    xsd_int,
+    xsd_date,
+};
+
+/**
+ * Encoding of inlined literals into the 42-bit LiteralID payload of a NodeID.
+ * Only canonical lexical forms are inlined, e.g. "1"^^xsd:integer but not "01"^^xsd:integer,
+ * so decoding gives back exactly the lexical form the literal was created with.
+ * The encoding is order-preserving: for two literals of the same datatype, comparing their IDs compares their values.
+ * Range filters on these datatypes can therefore run on IDs alone.
+ */
+struct InlinedLiteral {
+    static constexpr unsigned payload_bits = 42;
+    static constexpr size_t datatype_count = 5;
+
+    /**
+     * Datatype IRIs, indexed by InlinedDatatype value - 1.
+     */
+    static constexpr std::array<std::string_view, datatype_count> datatype_iris{
+            "http://www.w3.org/2001/XMLSchema#boolean",
+            "http://www.w3.org/2001/XMLSchema#integer",
+            "http://www.w3.org/2001/XMLSchema#long",
+            "http://www.w3.org/2001/XMLSchema#int",
+            "http://www.w3.org/2001/XMLSchema#date",
+    };
+
+    [[nodiscard]] static constexpr size_t index_of(InlinedDatatype datatype) noexcept {
+        return static_cast<size_t>(datatype) - 1;
+    }
+
+    [[nodiscard]] static constexpr InlinedDatatype datatype_at(size_t index) noexcept {
+        return static_cast<InlinedDatatype>(index + 1);
+    }
+
+    [[nodiscard]] static constexpr identifier::LiteralType literal_type(InlinedDatatype datatype) noexcept {
+        return static_cast<identifier::LiteralType>(datatype);
+    }
+
+    /**
+     * @return the inlined datatype tagged by type, or nothing for LiteralType::OTHER and unknown tags
+     */
+    [[nodiscard]] static constexpr std::optional<InlinedDatatype> datatype_of(identifier::LiteralType type) noexcept {
+        auto const tag = static_cast<size_t>(type);
+        if (tag == 0 || tag > datatype_count)
+            return std::nullopt;
+        return static_cast<InlinedDatatype>(tag);
+    }
+
+    /**
+     * @return the payload for lexical, or nothing if lexical is not canonical or its value does not fit
+     */
+    [[nodiscard]] static std::optional<uint64_t> encode(InlinedDatatype datatype, std::string_view lexical) noexcept;
+
+    /**
+     * @return the canonical lexical form of payload
+     */
+    [[nodiscard]] static std::string decode(InlinedDatatype datatype, uint64_t payload);
+
+    /**
+     * @param datatype_ids NodeIDs of the datatype IRIs in a store, indexed by index_of
+     * @return the NodeID that encodes view directly, or the null NodeID if view has to be stored
+     */
+    [[nodiscard]] static identifier::NodeID id_of(std::array<identifier::NodeID, datatype_count> const &datatype_ids,
+                                                  view::LiteralBackendView const &view) noexcept;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_INLINEDLITERAL_HPP
@@ -0,0 +1,22 @@
+#include "LiteralArena.hpp"
+
+#include <stdexcept>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+template<StoragePolicy Policy>
+LiteralArena<Policy>::LiteralArena(Alloc const &alloc) : lexical_forms_(alloc), language_tags_(alloc) {}
+
+template<StoragePolicy Policy>
+uint16_t LiteralArena<Policy>::intern_language_tag(std::string_view language_tag) {
+    if (language_tag.empty())
+        return no_language_tag;
+    uint32_t const id = language_tags_.find_or_add(language_tag);
+    if (id == 0)
+        throw std::length_error("Too many distinct language tags.");
+    return static_cast<uint16_t>(id);
+}
+
+template class LiteralArena<MetallPolicy>;
+template class LiteralArena<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef METALL_LITERALARENA_HPP
+#define METALL_LITERALARENA_HPP
+
+#include "StoragePolicy.hpp"
+#include "StringArena.hpp"
+#include "StringDictionary.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Id of the empty language tag.
+ */
+inline constexpr uint16_t no_language_tag = 0;
+
+/**
+ * Strings of the stored literals: a StringArena for the lexical forms and a StringDictionary that interns the language tags.
+ * There are only a few hundred distinct language tags in practice, so a literal record refers to its tag by a 16-bit id.
+ * Thread-safe like StringArena.
+ */
+template<StoragePolicy Policy>
+class LiteralArena {
+public:
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+private:
+    StringArena<Policy> lexical_forms_;
+    StringDictionary<Policy> language_tags_;
+
+public:
+    explicit LiteralArena(Alloc const &alloc);
+
+    LiteralArena(LiteralArena const &) = delete;
+    LiteralArena &operator=(LiteralArena const &) = delete;
+
+    /**
+     * Copies lexical_form into the arena.
+     * @throws std::length_error if the arena is full
+     */
+    StringRef append(std::string_view lexical_form) {
+        return lexical_forms_.append(lexical_form);
+    }
+
+    [[nodiscard]] std::string_view view(StringRef ref) const noexcept {
+        return lexical_forms_.view(ref);
+    }
+
+    /**
+     * @return id of language_tag, interning it if necessary
+     * @throws std::length_error if there are too many distinct language tags
+     */
+    uint16_t intern_language_tag(std::string_view language_tag);
+
+    /**
+     * @return id of language_tag, or no_language_tag if it was never interned
+     */
+    [[nodiscard]] uint16_t find_language_tag(std::string_view language_tag) const noexcept {
+        return static_cast<uint16_t>(language_tags_.find(language_tag));
+    }
+
+    [[nodiscard]] std::string_view language_tag(uint16_t id) const noexcept {
+        return language_tags_.view(id);
+    }
+
+    [[nodiscard]] uint32_t language_tag_count() const noexcept {
+        return language_tags_.size();
+    }
+
+    /**
+     * See StringArena::for_each_chunk. Visits the language tags first.
+     */
+    template<typename F>
+    void for_each_chunk(F &&f) const {
+        language_tags_.for_each_chunk(f);
+        lexical_forms_.for_each_chunk(f);
+    }
+
+    [[nodiscard]] uint64_t bytes_used() const noexcept {
+        return lexical_forms_.bytes_used() + language_tags_.bytes_used();
+    }
+
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return lexical_forms_.bytes_reserved() + language_tags_.bytes_reserved();
+    }
+
+    [[nodiscard]] uint64_t string_bytes() const noexcept {
+        return lexical_forms_.string_bytes() + language_tags_.string_bytes();
+    }
+
+    /**
+     * Number of lexical forms, the language tags are not counted.
+     */
+    [[nodiscard]] uint64_t string_count() const noexcept {
+        return lexical_forms_.string_count();
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_LITERALARENA_HPP
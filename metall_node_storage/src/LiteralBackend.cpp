@@ -1,73 +1,81 @@
 #include "LiteralBackend.hpp"
 
-#include <sstream>
-#include <tuple>
+#include <cstdint>
+#include <cstring>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
-LiteralBackend::LiteralBackend(std::string_view lexical, identifier::NodeID dataType, std::string_view langTag) noexcept
-    : datatype_id_(dataType),
-      lexical(lexical),
-      lang_tag(langTag) {}
-LiteralBackend::LiteralBackend(view::LiteralBackendView view) noexcept : datatype_id_(view.datatype_id), lexical(view.lexical_form), lang_tag(view.language_tag){};
+std::string LiteralBackend::quote_lexical(std::string_view lexical) noexcept {
+    std::string out;
+    out.reserve(lexical.size() + 2);
+    quote_lexical(lexical, out);
+    return out;
+}
+
+/**
+ * @return true if any byte of word is a control character, '"', '\\' or DEL
+ */
+static bool needs_escape(uint64_t word) noexcept {
+    constexpr uint64_t ones = 0x0101010101010101;
+    constexpr uint64_t highs = 0x8080808080808080;
+    auto has_byte = [](uint64_t x, uint8_t byte) {
+        uint64_t const y = x ^ (ones * byte);
+        return (y - ones) & ~y & highs;
+    };
+    uint64_t const below_space = (word - ones * 0x20) & ~word & highs;
+    return (below_space | has_byte(word, '"') | has_byte(word, '\\') | has_byte(word, 0x7f)) != 0;
+}
 
-std::partial_ordering LiteralBackend::operator<=>(LiteralBackend const &other) const noexcept {
-    return std::tie(this->datatype_id_, this->lexical, this->lang_tag) <=> std::tie(other.datatype_id_, other.lexical, other.lang_tag);
+static bool needs_escape(char character) noexcept {
+    auto const byte = static_cast<unsigned char>(character);
+    return byte < 0x20 || byte == '"' || byte == '\\' || byte == 0x7f;
 }
 
-std::string LiteralBackend::quote_lexical() const noexcept {
-    // TODO: covers only the most common cases. There might still be characters that are not allowed in N-Triple strings
-    std::ostringstream out{};
-    out << "\"";
+/**
+ * @return length of the prefix of str that needs no escaping, checking 8 bytes at a time
+ */
+static size_t clean_run(std::string_view str) noexcept {
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= str.size(); pos += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, str.data() + pos, sizeof(word));
+        if (needs_escape(word))
+            break;
+    }
+    while (pos < str.size() && !needs_escape(str[pos]))
+        ++pos;
+    return pos;
+}
 
-    for (auto const &character : lexical) {
+void LiteralBackend::quote_lexical(std::string_view lexical, std::string &out) {
+    out += '"';
+    while (!lexical.empty()) {
+        size_t const clean = clean_run(lexical);
+        out.append(lexical.data(), clean);
+        if (clean == lexical.size())
+            break;
+
+        auto const character = static_cast<unsigned char>(lexical[clean]);
         switch (character) {
-            case '\n': {
-                out << R"(\n)";
-                break;
-            }
-            case '\r': {
-                out << R"(\r)";
+            case '\b': out += R"(\b)"; break;
+            case '\t': out += R"(\t)"; break;
+            case '\n': out += R"(\n)"; break;
+            case '\f': out += R"(\f)"; break;
+            case '\r': out += R"(\r)"; break;
+            case '"': out += R"(\")"; break;
+            case '\\': out += R"(\\)"; break;
+            default: {
+                constexpr char hex[] = "0123456789ABCDEF";
+                char const escaped[] = {'\\', 'u', '0', '0', hex[character >> 4], hex[character & 0xf]};
+                out.append(escaped, sizeof(escaped));
                 break;
             }
-            case '"': {
-                out << R"(\")";
-                break;
-            }
-                [[likely]] default : {
-                    out << character;
-                    break;
-                }
         }
+        lexical.remove_prefix(clean + 1);
     }
-    out << "\"";
-    return out.str();
-}
-bool LiteralBackend::operator==(LiteralBackend const &other) const noexcept {
-    return std::tie(this->datatype_id_, this->lexical, this->lang_tag) == std::tie(other.datatype_id_, other.lexical, other.lang_tag);
-}
-std::partial_ordering LiteralBackend::operator<=>(metall::offset_ptr<LiteralBackend> const &other) const noexcept {
-    if (other)
-        return *this <=> *other;
-    else
-        return std::partial_ordering::greater;
-}
-std::string_view LiteralBackend::language_tag() const noexcept {
-    return lang_tag;
+    out += '"';
 }
 const identifier::NodeID &LiteralBackend::datatype_id() const noexcept {
     return datatype_id_;
 }
-std::string_view LiteralBackend::lexical_form() const noexcept {
-    return lexical;
-}
-LiteralBackend::operator view::LiteralBackendView() const noexcept {
-    return {.datatype_id = datatype_id(),
-            .lexical_form = lexical_form(),
-            .language_tag = language_tag()};
-}
-
-std::partial_ordering operator<=>(metall::offset_ptr<LiteralBackend> const &self, metall::offset_ptr<LiteralBackend> const &other) noexcept {
-    return *self <=> *other;
-}
 }  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -1,52 +1,122 @@
 #ifndef METALL_LITERALBACKEND_HPP
 #define METALL_LITERALBACKEND_HPP
 
-#include <metall/metall.hpp>
-
 #include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
 #include <rdf4cpp/rdf/storage/node/view/LiteralBackendView.hpp>
 
-#include <compare>
-#include <memory>
+#include "LiteralArena.hpp"
+
+#include <cstdint>
 #include <string>
 #include <string_view>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
+/**
+ * Stored literal. The lexical form lives in a LiteralArena, the record only keeps its position.
+ * The language tag is interned in the LiteralArena and kept as a 16-bit id next to the datatype.
+ */
 class LiteralBackend {
     identifier::NodeID datatype_id_;
-    std::string lexical;
-    std::string lang_tag;
+    uint16_t language_tag_id_ = no_language_tag;
+    StringRef lexical;
 
 public:
-    [[nodiscard]] std::string quote_lexical() const noexcept;
-    LiteralBackend(std::string_view lexical, identifier::NodeID dataType, std::string_view langTag = "") noexcept;
-    explicit LiteralBackend(view::LiteralBackendView view) noexcept;
-    std::partial_ordering operator<=>(LiteralBackend const &) const noexcept;
-    auto operator<=>(view::LiteralBackendView const &other) const noexcept {
-        return view::LiteralBackendView(*this) <=> other;
+    LiteralBackend() noexcept = default;
+    template<StoragePolicy Policy>
+    LiteralBackend(LiteralArena<Policy> &arena, std::string_view lexical, identifier::NodeID dataType, std::string_view langTag = "")
+        : datatype_id_(dataType),
+          language_tag_id_(arena.intern_language_tag(langTag)),
+          lexical(arena.append(lexical)) {}
+    template<StoragePolicy Policy>
+    LiteralBackend(LiteralArena<Policy> &arena, view::LiteralBackendView view)
+        : LiteralBackend(arena, view.lexical_form, view.datatype_id, view.language_tag) {}
+
+    [[nodiscard]] bool null() const noexcept {
+        return lexical.null();
+    }
+
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string quote_lexical(LiteralArena<Policy> const &arena) const noexcept {
+        return quote_lexical(lexical_form(arena));
     }
-    std::partial_ordering operator<=>(metall::offset_ptr<LiteralBackend> const &other) const noexcept;
 
-    bool operator==(const LiteralBackend &) const noexcept;
+    /**
+     * lexical in double quotes, escaped for N-Triples.
+     */
+    [[nodiscard]] static std::string quote_lexical(std::string_view lexical) noexcept;
+    /**
+     * Appends lexical in double quotes to out, escaped for N-Triples: '"', '\\', and the control characters,
+     * as \b, \t, \n, \f, \r or \u00XX. Runs that need no escaping are copied in bulk.
+     * Does not allocate unless out has to grow.
+     */
+    static void quote_lexical(std::string_view lexical, std::string &out);
 
-    [[nodiscard]] std::string_view lexical_form() const noexcept;
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string_view lexical_form(LiteralArena<Policy> const &arena) const noexcept {
+        return arena.view(lexical);
+    }
 
     [[nodiscard]] const identifier::NodeID &datatype_id() const noexcept;
 
-    [[nodiscard]] std::string_view language_tag() const noexcept;
+    [[nodiscard]] uint16_t language_tag_id() const noexcept {
+        return language_tag_id_;
+    }
 
-    explicit operator view::LiteralBackendView() const noexcept;
-};
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string_view language_tag(LiteralArena<Policy> const &arena) const noexcept {
+        return arena.language_tag(language_tag_id_);
+    }
+
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::LiteralBackendView view(LiteralArena<Policy> const &arena) const noexcept {
+        return {.datatype_id = datatype_id(),
+                .lexical_form = lexical_form(arena),
+                .language_tag = language_tag(arena)};
+    }
 
+    /**
+     * The record is contiguous in the arena, buffer is not used. Same interface as IRIBackend.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::LiteralBackendView view(LiteralArena<Policy> const &arena, [[maybe_unused]] std::string &buffer) const noexcept {
+        return view(arena);
+    }
 
-std::partial_ordering operator<=>(metall::offset_ptr<LiteralBackend> const &self, metall::offset_ptr<LiteralBackend> const &other) noexcept;
-}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+    /**
+     * language_tag_key of a tag that was not interned when it was looked up. It may have been interned since, so it is compared as a string.
+     */
+    static constexpr uint32_t unknown_language_tag = UINT32_MAX;
+
+    /**
+     * @return the id of language_tag in arena, or unknown_language_tag. To be looked up once per lookup and passed to equals.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] static uint32_t language_tag_key(LiteralArena<Policy> const &arena, std::string_view language_tag) noexcept {
+        if (language_tag.empty())
+            return no_language_tag;
+        uint16_t const id = arena.find_language_tag(language_tag);
+        return id == no_language_tag ? unknown_language_tag : id;
+    }
 
-namespace rdf4cpp::rdf::storage::node::view {
-inline std::partial_ordering operator<=>(LiteralBackendView const &lhs, metall::offset_ptr<metall_node_storage::LiteralBackend> const &rhs) noexcept {
-    return lhs <=> LiteralBackendView(*rhs);
-}
-}  // namespace rdf4cpp::rdf::storage::node::view
+    /**
+     * Compares datatype and language tag id first, the lexical form last.
+     * @param language_tag_key language_tag_key of view.language_tag
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] bool equals(LiteralArena<Policy> const &arena, view::LiteralBackendView const &view, uint32_t language_tag_key) const noexcept {
+        if (datatype_id_ != view.datatype_id)
+            return false;
+        bool const same_tag = language_tag_key == unknown_language_tag ? arena.language_tag(language_tag_id_) == view.language_tag
+                                                                        : language_tag_id_ == language_tag_key;
+        return same_tag && lexical_form(arena) == view.lexical_form;
+    }
+
+    template<StoragePolicy Policy>
+    [[nodiscard]] bool equals(LiteralArena<Policy> const &arena, view::LiteralBackendView const &view) const noexcept {
+        return equals(arena, view, language_tag_key(arena, view.language_tag));
+    }
+};
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
 
 #endif  //METALL_LITERALBACKEND_HPP
@@ -0,0 +1,146 @@
+#include "MappingOptions.hpp"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+using NodeMask = std::array<unsigned long, 16>;
+
+/**
+ * Rounds [address, address + size) out to whole pages.
+ * @return start and length of the page-aligned range
+ */
+static std::pair<void *, size_t> page_range(void const *address, size_t size) noexcept {
+    auto const page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    auto const begin = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+    auto const end = (reinterpret_cast<uintptr_t>(address) + size + page_size - 1) & ~(page_size - 1);
+    return {reinterpret_cast<void *>(begin), end - begin};
+}
+
+/**
+ * madvise that tolerates unmapped gaps in the range, which make it fail with ENOMEM after advising the mapped parts.
+ */
+static bool advise(void const *address, size_t size, int advice) noexcept {
+    auto const [begin, length] = page_range(address, size);
+    return ::madvise(begin, length, advice) == 0 || errno == ENOMEM;
+}
+
+/**
+ * Parses /sys/devices/system/node/online, e.g. "0-1,3".
+ * @return false if the machine has no NUMA support
+ */
+static bool online_nodes(NodeMask &mask) {
+    std::ifstream file{"/sys/devices/system/node/online"};
+    std::string list;
+    if (!std::getline(file, list))
+        return false;
+
+    mask.fill(0);
+    constexpr unsigned bits = sizeof(unsigned long) * CHAR_BIT;
+    std::istringstream ranges{list};
+    for (std::string range; std::getline(ranges, range, ',');) {
+        size_t const dash = range.find('-');
+        unsigned long const first = std::stoul(range.substr(0, dash));
+        unsigned long const last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned long node = first; node <= last && node < mask.size() * bits; ++node)
+            mask[node / bits] |= 1UL << (node % bits);
+    }
+    return true;
+}
+
+/**
+ * Looks address up in /proc/self/maps.
+ * @return true if address is in a mapping of a regular file, whose page cache ignores memory policies.
+ * Shared memory objects in /dev/shm and memfds take the policy like anonymous memory.
+ */
+static bool maps_regular_file(void const *address) {
+    auto const target = reinterpret_cast<uintptr_t>(address);
+    std::ifstream maps{"/proc/self/maps"};
+    for (std::string line; std::getline(maps, line);) {
+        // start-end perms offset dev inode path
+        std::istringstream fields{line};
+        uintptr_t begin = 0;
+        uintptr_t end = 0;
+        char dash = 0;
+        std::string perms, offset, dev;
+        uint64_t inode = 0;
+        std::string path;
+        fields >> std::hex >> begin >> dash >> end >> perms >> offset >> dev >> std::dec >> inode >> path;
+        if (target < begin || target >= end)
+            continue;
+        return inode != 0 && !path.starts_with("/dev/shm/") && !path.starts_with("/memfd:");
+    }
+    return false;
+}
+
+bool advise_mapping(void const *address, size_t size, MappingOptions const &options) noexcept {
+    bool ok = true;
+    switch (options.huge_pages) {
+        case HugePages::system_default:
+            break;
+        case HugePages::transparent:
+            ok &= advise(address, size, MADV_HUGEPAGE);
+            break;
+        case HugePages::disabled:
+            ok &= advise(address, size, MADV_NOHUGEPAGE);
+            break;
+    }
+    switch (options.access_pattern) {
+        case AccessPattern::normal:
+            ok &= advise(address, size, MADV_NORMAL);
+            break;
+        case AccessPattern::sequential:
+            ok &= advise(address, size, MADV_SEQUENTIAL);
+            break;
+        case AccessPattern::random:
+            ok &= advise(address, size, MADV_RANDOM);
+            break;
+    }
+    return ok;
+}
+
+bool interleave_numa(void const *address, size_t size) noexcept {
+    NodeMask mask;
+    try {
+        if (!online_nodes(mask) || maps_regular_file(address))
+            return false;
+    } catch (...) {
+        return false;
+    }
+
+    auto const [begin, length] = page_range(address, size);
+    // the kernel reads maxnode - 1 bits of the mask
+    unsigned long const max_node = mask.size() * sizeof(unsigned long) * CHAR_BIT + 1;
+    return ::syscall(SYS_mbind, begin, length, MPOL_INTERLEAVE, mask.data(), max_node, MPOL_MF_MOVE) == 0;
+}
+
+bool populate(void const *address, size_t size) noexcept {
+    if (size == 0)
+        return true;
+    auto const [begin, length] = page_range(address, size);
+    bool const ok = ::madvise(begin, length, MADV_WILLNEED) == 0;
+#ifdef MADV_POPULATE_READ
+    if (::madvise(begin, length, MADV_POPULATE_READ) == 0)
+        return ok;
+    if (errno != EINVAL)
+        return false;
+#endif
+    auto const page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    auto const *const bytes = static_cast<char const volatile *>(begin);
+    for (size_t offset = 0; offset < length; offset += page_size)
+        static_cast<void>(bytes[offset]);
+    return ok;
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef METALL_MAPPINGOPTIONS_HPP
+#define METALL_MAPPINGOPTIONS_HPP
+
+#include <cstddef>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Page size of the datastore mapping. Explicit huge pages cannot be requested on an existing mapping,
+ * for those the datastore has to be placed on a hugetlbfs mount.
+ */
+enum struct HugePages {
+    system_default,
+    /**
+     * MADV_HUGEPAGE. Whether file-backed mappings get huge pages depends on the kernel and the filesystem.
+     */
+    transparent,
+    /**
+     * MADV_NOHUGEPAGE.
+     */
+    disabled,
+};
+
+/**
+ * Expected access pattern of the datastore mapping, passed to madvise.
+ */
+enum struct AccessPattern {
+    normal,
+    /**
+     * Bulk loading: aggressive read-ahead.
+     */
+    sequential,
+    /**
+     * Serving lookups: no read-ahead, only the touched pages are read.
+     */
+    random,
+};
+
+/**
+ * Placement hints for the memory of a Metall datastore. All of them are best-effort, the kernel may ignore them.
+ */
+struct MappingOptions {
+    HugePages huge_pages = HugePages::system_default;
+    AccessPattern access_pattern = AccessPattern::normal;
+    /**
+     * Interleave the pages of the reverse indexes over all online NUMA nodes. Lookups hash to random index pages,
+     * so on a multi-socket machine interleaving gives every socket the same average latency and spreads the bandwidth.
+     * Only takes effect for stores on the heap, see interleave_numa. advise reports false for file-backed mappings.
+     */
+    bool interleave_index = false;
+};
+
+/**
+ * Applies huge_pages and access_pattern to [address, address + size), rounded out to whole pages.
+ * Metall reserves more address space than it maps, gaps in the range are skipped.
+ * @return false if the kernel rejected a hint
+ */
+bool advise_mapping(void const *address, size_t size, MappingOptions const &options) noexcept;
+
+/**
+ * Sets an interleaving memory policy over all online NUMA nodes for [address, address + size)
+ * and migrates the pages that are already there.
+ * A no-op for mappings of regular files, e.g. a Metall datastore or a frozen image: their pages live in the page cache,
+ * which mbind does not place. Only anonymous and shared memory, e.g. a HeapPolicy store, is interleaved.
+ * @return false if NUMA is not available, address is in a mapping of a regular file or the policy was rejected
+ */
+bool interleave_numa(void const *address, size_t size) noexcept;
+
+/**
+ * Reads [address, address + size) into the page cache and maps it into the page tables:
+ * MADV_WILLNEED, then MADV_POPULATE_READ or, on kernels without it, a read of one byte per page.
+ * The range must be mapped completely.
+ * @return false if the kernel rejected the read-ahead
+ */
+bool populate(void const *address, size_t size) noexcept;
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_MAPPINGOPTIONS_HPP
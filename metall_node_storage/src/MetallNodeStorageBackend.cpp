@@ -1,169 +1,770 @@
 #include "MetallNodeStorageBackend.hpp"
 
+#include "RecordEqual.hpp"
+
+#include <fcntl.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
 #include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
 //#include "../metall/include/metall/metall.hpp"
 #include <metall/metall.hpp>
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
-    using Alloc = metall::manager::allocator_type<std::byte>;
+using NodeTypeFrontCache = FrontCache<>;
 
-    template<typename T>
-    using metallMap = typename metall::container::map<identifier::NodeID,typename metall::offset_ptr<T>, std::less<>>;
+/**
+ * Front caches of the calling thread. They belong to one backend at a time and are cleared when the thread
+ * switches to another one, because NodeIDs of different stores are unrelated.
+ */
+struct ThreadFrontCaches {
+    uint64_t owner = 0;
+    NodeTypeFrontCache literal;
+    NodeTypeFrontCache bnode;
+    NodeTypeFrontCache iri;
+    NodeTypeFrontCache variable;
+};
 
-    template<typename T>
-    using metallReverseMap = typename metall::container::map<typename metall::offset_ptr<T>,identifier::NodeID, std::less<>>;
+thread_local ThreadFrontCaches thread_front_caches;
 
-    template<typename T>
-    using ptrMetallMap = metall::offset_ptr<metallMap<T>>;
+static std::atomic<uint64_t> next_instance_id = 1;
 
-    template<typename T>
-    using ptrmMetallReverseMap = metall::offset_ptr<metallReverseMap<T>>;
+static ThreadFrontCaches *front_caches_of(uint64_t owner, bool enabled) noexcept {
+    if (!enabled)
+        return nullptr;
+    ThreadFrontCaches &caches = thread_front_caches;
+    if (caches.owner != owner) {
+        caches.literal.clear();
+        caches.bnode.clear();
+        caches.iri.clear();
+        caches.variable.clear();
+        caches.owner = owner;
+    }
+    return &caches;
+}
 
-    template<typename U>
-    using allocMap = typename metall::manager::allocator_type<U>;
+template<StoragePolicy Policy>
+static BasicNodeStore<Policy> *attach_store(typename Policy::manager_type &manager, char const *store_name) {
+    BasicNodeStore<Policy> *store;
+    if (manager.read_only()) {
+        store = manager.template find<BasicNodeStore<Policy>>(store_name).first;
+        if (store == nullptr)
+            throw std::runtime_error("The datastore does not contain a node store named " + std::string{store_name} + ".");
+    } else {
+        store = manager.template find_or_construct<BasicNodeStore<Policy>>(store_name)(manager.get_allocator());
+    }
+    store->validate();
+    return store;
+}
 
-    template<typename U>
-    using AllocTraitsMetallMap = std::allocator_traits<allocMap<U>>;
+/**
+ * @return true if the first extent of the largest file below path is shared with another file, i.e. it was reflinked
+ */
+static bool shares_extents(std::filesystem::path const &path) {
+    std::error_code ec;
+    std::filesystem::path largest = path;
+    uintmax_t largest_size = std::filesystem::is_regular_file(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    for (auto const &entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+        if (entry.is_regular_file(ec) && entry.file_size(ec) > largest_size) {
+            largest = entry.path();
+            largest_size = entry.file_size(ec);
+        }
+    }
+    if (largest_size == 0)
+        return false;
 
-    template<typename U>
-    void initStorage(ptrMetallMap<U>& ptrStorage, ptrmMetallReverseMap<U>& ptrReverseStorage, const Alloc& alloc){
-        typename metall::manager::allocator_type<metallMap<U>> rebindAlloc = alloc;
-        ptrStorage = AllocTraitsMetallMap<metallMap<U>>::allocate(rebindAlloc, 1);
-        rebindAlloc.construct(ptrStorage, alloc);
+    int const fd = ::open(largest.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    alignas(struct fiemap) std::array<std::byte, sizeof(struct fiemap) + sizeof(struct fiemap_extent)> request{};
+    auto *const map = reinterpret_cast<struct fiemap *>(request.data());
+    map->fm_length = FIEMAP_MAX_OFFSET;
+    map->fm_extent_count = 1;
+    bool const shared = ::ioctl(fd, FS_IOC_FIEMAP, map) == 0 && map->fm_mapped_extents > 0 &&
+                        (map->fm_extents[0].fe_flags & FIEMAP_EXTENT_SHARED) != 0;
+    ::close(fd);
+    return shared;
+}
 
-        typename metall::manager::allocator_type<metallReverseMap<U>> rebindReverseAlloc = alloc;
-        ptrReverseStorage = AllocTraitsMetallMap<metallReverseMap<U>>::allocate(rebindReverseAlloc, 1);
-        rebindReverseAlloc.construct(ptrReverseStorage, alloc);
+/**
+ * @return bytes of the file at path, or of all regular files below it
+ */
+static uint64_t apparent_size(std::filesystem::path const &path) {
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(path, ec))
+        return std::filesystem::file_size(path, ec);
+    uint64_t bytes = 0;
+    for (auto const &entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+        if (entry.is_regular_file(ec))
+            bytes += entry.file_size(ec);
     }
+    return bytes;
+}
 
-MetallNodeStorageBackend::MetallNodeStorageBackend(const Alloc &al) : INodeStorageBackend(), alloc(al) {  // TODO why call INodeStorageBackend ?
+template<StoragePolicy Policy>
+BasicNodeStorageBackend<Policy>::BasicNodeStorageBackend(Manager &manager, char const *store_name)
+    : INodeStorageBackend(),
+      manager_(&manager),
+      store_(attach_store<Policy>(manager, store_name)),
+      read_only_(manager.read_only()),
+      instance_id_(next_instance_id.fetch_add(1, std::memory_order_relaxed)),
+      literal_locks_(store_->literal_storage_reverse->stripe_count()),
+      bnode_locks_(store_->bnode_storage_reverse->stripe_count()),
+      iri_locks_(store_->iri_storage_reverse->stripe_count()),
+      variable_locks_(store_->variable_storage_reverse->stripe_count()),
+      checkpoint_arena_bytes_(arena_bytes_used())
+#ifdef METALL_NODE_STORAGE_DEBUG_VIEWS
+      ,
+      view_checker_(manager.get_address(), manager.get_size())
+#endif
+{
+}
+template<StoragePolicy Policy>
+BasicNodeStorageBackend<Policy>::BasicNodeStorageBackend(Manager &manager, MappingOptions const &options, char const *store_name)
+    : BasicNodeStorageBackend(manager, store_name) {
+    advise(options);
+}
 
-        initStorage<LiteralBackend>(literal_storage,literal_storage_reverse, alloc);
-        initStorage<BNodeBackend>(bnode_storage,bnode_storage_reverse, alloc);
-        initStorage<IRIBackend>(iri_storage,iri_storage_reverse, alloc);
-        initStorage<VariableBackend>(variable_storage,variable_storage_reverse, alloc);
+template<StoragePolicy Policy>
+bool BasicNodeStorageBackend<Policy>::advise(MappingOptions const &options) const {
+    bool ok = advise_mapping(manager_->get_address(), manager_->get_size(), options);
+    if (options.interleave_index) {
+        auto const interleave = [&](NodeTypeLocks &locks, auto const &reverse_storage) {
+            for (size_t stripe = 0; stripe < reverse_storage->stripe_count(); ++stripe) {
+                // keeps the table from being reallocated by a concurrent insert
+                std::shared_lock<std::shared_mutex> shared_lock = locks.shared(stripe);
+                HashIndex<Policy> const &index = reverse_storage->stripe(stripe);
+                ok &= interleave_numa(index.data(), index.bytes());
+            }
+        };
+        interleave(literal_locks_, store_->literal_storage_reverse);
+        interleave(bnode_locks_, store_->bnode_storage_reverse);
+        interleave(iri_locks_, store_->iri_storage_reverse);
+        interleave(variable_locks_, store_->variable_storage_reverse);
+    }
+    return ok;
+}
+
+template<StoragePolicy Policy>
+std::unique_ptr<WarmUp> BasicNodeStorageBackend<Policy>::warm_up(WarmUpOptions options) const
+    requires std::same_as<Policy, MetallPolicy>
+{
+    std::vector<WarmUpRegion> regions;
+    auto const add = [&regions](WarmUpPhase phase) {
+        return [&regions, phase](void const *address, size_t size) {
+            regions.push_back(WarmUpRegion{.address = address, .size = size, .phase = phase});
+        };
+    };
+    auto const add_index = [&](NodeTypeLocks &locks, auto const &reverse_storage) {
+        for (size_t stripe = 0; stripe < reverse_storage->stripe_count(); ++stripe) {
+            // the table may move once the lock is released. Its old memory stays within the mapped datastore
+            // (only MetallPolicy, see warm_up), so loading it is wasted at worst
+            std::shared_lock<std::shared_mutex> shared_lock = locks.shared(stripe);
+            HashIndex<Policy> const &index = reverse_storage->stripe(stripe);
+            add(WarmUpPhase::index)(index.data(), index.bytes());
+        }
+    };
+    add_index(iri_locks_, store_->iri_storage_reverse);
+    add_index(literal_locks_, store_->literal_storage_reverse);
+    add_index(bnode_locks_, store_->bnode_storage_reverse);
+    add_index(variable_locks_, store_->variable_storage_reverse);
 
-    for (const auto &[id, iri] : NodeID::predefined_iris) {
-        typename metall::manager::allocator_type<IRIBackend> rebind_alloc = alloc;  // cast the allocator to the type you require
-        auto mem = rebind_alloc.allocate(1);                                       // request memory
-        rebind_alloc.construct(mem, iri);                            // construct MetallIRIBackend at mem
+    store_->iri_storage->for_each_segment(add(WarmUpPhase::forward));
+    store_->literal_storage->for_each_segment(add(WarmUpPhase::forward));
+    store_->bnode_storage->for_each_segment(add(WarmUpPhase::forward));
+    store_->variable_storage->for_each_segment(add(WarmUpPhase::forward));
 
-        auto [iter, inserted_successfully] = iri_storage_reverse->emplace(metall::offset_ptr<IRIBackend>(mem), id);
+    store_->iri_arena->for_each_chunk(add(WarmUpPhase::strings));
+    store_->literal_arena->for_each_chunk(add(WarmUpPhase::strings));
+    store_->bnode_arena->for_each_chunk(add(WarmUpPhase::strings));
+    store_->variable_arena->for_each_chunk(add(WarmUpPhase::strings));
 
-        assert(inserted_successfully);
-        iri_storage->insert({id, metall::offset_ptr<IRIBackend>(mem)});
-    }
+    return std::make_unique<WarmUp>(regions, std::move(options));
 }
-template<class Backend_t, bool create_if_not_present, class View_t, class Storage_t, class ReverseStorage_t, class NextIDFromView_func = void *>
-inline identifier::NodeID lookup_or_insert_impl(View_t view, std::shared_mutex &mutex,const metall::offset_ptr<Storage_t> &storage,
-                                                const metall::offset_ptr<ReverseStorage_t> &reverse_storage, const Alloc& alloc, const
-                                                NextIDFromView_func next_id_func = nullptr) noexcept {
-    std::shared_lock<std::shared_mutex> shared_lock{mutex};
-    auto found = reverse_storage->find(view);
-    if (found == reverse_storage->end()) {
-        if constexpr (create_if_not_present) {
-            shared_lock.unlock();
-            std::unique_lock<std::shared_mutex> unique_lock{mutex};
+
+template<class Backend_t, bool create_if_not_present, class View_t, class Locks_t, class StoragePtr_t, class ReverseStoragePtr_t, class ArenaPtr_t, class NextIDFromView_func = void *>
+inline identifier::NodeID lookup_or_insert_impl(View_t view, Locks_t &locks, const StoragePtr_t &storage,
+                                                const ReverseStoragePtr_t &reverse_storage, const ArenaPtr_t &arena, bool read_only,
+                                                NodeTypeFrontCache *cache, const NextIDFromView_func next_id_func = nullptr) noexcept {
+    // hash outside of the lock, the critical section is only the probe
+    uint64_t const hash = ViewHash{}(view);
+    RecordEqual const equal{*storage, *arena, view};
+
+    // the forward table is lock-free, so a cache hit takes no lock at all.
+    // Erased records stay readable, a cached id has to be checked for a tombstone.
+    if (cache != nullptr) {
+        identifier::NodeID const cached = cache->find(hash, [&](identifier::NodeID id) {
+            return storage->contains(id) && equal(id);
+        });
+        if (!cached.null())
+            return cached;
+    }
+
+    size_t const stripe = reverse_storage->stripe_of(hash);
+    auto &index = reverse_storage->stripe(stripe);
+
+    identifier::NodeID found;
+    {
+        std::shared_lock<std::shared_mutex> shared_lock = locks.shared(stripe);
+        found = index.find(hash, equal);
+    }
+    if constexpr (create_if_not_present) {
+        if (found.null() && !read_only) {
+            std::unique_lock<std::shared_mutex> unique_lock = locks.exclusive(stripe);
             // update found (might have changed in the meantime)
-            found = reverse_storage->find(view);
-            if (found == reverse_storage->end()) {
-                identifier::NodeID id = next_id_func(view);
-
-                typename metall::manager::allocator_type<Backend_t> rebind_alloc = alloc;
-                auto mem = rebind_alloc.allocate(1);
-                rebind_alloc.construct(mem, view);
-
-                auto [found, inserted_successfully] = reverse_storage->emplace(metall::offset_ptr<typename ReverseStorage_t::key_type::element_type>(mem), id);
-                assert(inserted_successfully);
-
-                storage->insert({id, metall::offset_ptr<typename ReverseStorage_t::key_type::element_type>(mem)});
-                return id;
-            } else {
-                unique_lock.unlock();
-                return found->second;
+            found = index.find(hash, equal);
+            if (found.null()) {
+                found = next_id_func(view);
+                // the record is complete before the id becomes visible through the index
+                storage->insert(found, Backend_t{*arena, view}, hash);
+                index.insert(hash, found);
             }
-        } else {
-            return {};
         }
-    } else {
-        shared_lock.unlock();
-        return found->second;
     }
+
+    // only ids are cached, a miss may turn into a hit once another thread adds the node
+    if (cache != nullptr && !found.null())
+        cache->insert(hash, found);
+    return found;
 }
-identifier::NodeID MetallNodeStorageBackend::find_or_make_id(view::LiteralBackendView const &view) noexcept {
+
+template<class Locks_t, class StoragePtr_t, class ReverseStoragePtr_t>
+inline bool erase_impl(identifier::NodeID id, Locks_t &locks, const StoragePtr_t &storage,
+                       const ReverseStoragePtr_t &reverse_storage, bool read_only) {
+    if (read_only)
+        throw std::runtime_error("Cannot erase nodes from a read-only datastore.");
+    if (!storage->contains(id))
+        return false;
+
+    // the record stays readable after the tombstone is set, so its hash can be read outside of the lock
+    uint64_t const hash = storage->hash(id);
+    size_t const stripe = reverse_storage->stripe_of(hash);
+    std::unique_lock<std::shared_mutex> unique_lock = locks.exclusive(stripe);
+    // another thread might have erased it in the meantime
+    if (!storage->erase(id))
+        return false;
+    reverse_storage->stripe(stripe).erase(hash, id);
+    return true;
+}
+
+template<class Backend_t, class View_t, class Locks_t, class StoragePtr_t, class ReverseStoragePtr_t, class ArenaPtr_t, class NextIDFromView_func>
+inline std::vector<identifier::NodeID> bulk_lookup_or_insert_impl(std::span<View_t const> views, Locks_t &locks, const StoragePtr_t &storage,
+                                                                  const ReverseStoragePtr_t &reverse_storage, const ArenaPtr_t &arena, bool read_only,
+                                                                  const NextIDFromView_func next_id_func) {
+    std::vector<identifier::NodeID> ids(views.size());
+
+    // hash and sort the batch outside of the locks. The stripe is the upper bits of the hash,
+    // so sorting by hash groups the batch by stripe and puts duplicates next to each other.
+    std::vector<uint64_t> hashes(views.size());
+    std::transform(views.begin(), views.end(), hashes.begin(), ViewHash{});
+    std::vector<size_t> order(views.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return hashes[lhs] < hashes[rhs]; });
+
+    struct Pending {
+        identifier::NodeID id;
+        uint64_t hash;
+    };
+    std::vector<Pending> pending;
+    std::vector<size_t> misses;
+    std::vector<std::pair<size_t, size_t>> duplicates;
+    for (auto stripe_begin = order.begin(); stripe_begin != order.end();) {
+        size_t const stripe = reverse_storage->stripe_of(hashes[*stripe_begin]);
+        auto const stripe_end = std::find_if(stripe_begin, order.end(), [&](size_t i) { return reverse_storage->stripe_of(hashes[i]) != stripe; });
+        auto &index = reverse_storage->stripe(stripe);
+
+        if (read_only) {
+            std::shared_lock<std::shared_mutex> stripe_lock = locks.shared(stripe);
+            for (auto it = stripe_begin; it != stripe_end; ++it)
+                ids[*it] = index.find(hashes[*it], RecordEqual{*storage, *arena, views[*it]});
+            stripe_begin = stripe_end;
+            continue;
+        }
+
+        std::unique_lock<std::shared_mutex> stripe_lock = locks.exclusive(stripe);
+        misses.clear();
+        duplicates.clear();
+        for (auto it = stripe_begin; it != stripe_end; ++it) {
+            View_t const &view = views[*it];
+            uint64_t const hash = hashes[*it];
+            // duplicate inside the batch, equal views have equal hashes and are sorted next to each other
+            auto const duplicate = std::find_if(std::make_reverse_iterator(it), std::make_reverse_iterator(stripe_begin), [&](size_t i) {
+                return hashes[i] != hash || std::is_eq(views[i] <=> view);
+            });
+            if (duplicate != std::make_reverse_iterator(stripe_begin) && hashes[*duplicate] == hash) {
+                duplicates.emplace_back(*it, *duplicate);
+                continue;
+            }
+
+            ids[*it] = index.find(hash, RecordEqual{*storage, *arena, view});
+            if (ids[*it].null())
+                misses.push_back(*it);
+        }
+
+        if (!misses.empty()) {
+            // allocations happen under a stripe lock, so that pause_writers also stops them
+            storage->reserve(storage->size() + misses.size());
+            index.reserve(index.size() + misses.size());
+        }
+        pending.clear();
+        for (size_t const i : misses) {
+            ids[i] = next_id_func(views[i]);
+            storage->insert(ids[i], Backend_t{*arena, views[i]}, hashes[i]);
+            pending.push_back(Pending{.id = ids[i], .hash = hashes[i]});
+        }
+        // the records are complete, make them visible through the index
+        for (auto const &entry : pending)
+            index.insert(entry.hash, entry.id);
+        // in sorted order, so a duplicate of a duplicate is resolved after the one it refers to
+        for (auto const &[i, first] : duplicates)
+            ids[i] = ids[first];
+        stripe_begin = stripe_end;
+    }
+    return ids;
+}
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_or_make_id(view::LiteralBackendView const &view) noexcept {
+    if (identifier::NodeID const inlined = InlinedLiteral::id_of(store_->inlined_datatype_ids, view); !inlined.null())
+        return inlined;
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<LiteralBackend, true>(
-            view, literal_mutex_, literal_storage, literal_storage_reverse, alloc,
+            view, literal_locks_, store_->literal_storage, store_->literal_storage_reverse, store_->literal_arena, read_only_,
+            caches != nullptr ? &caches->literal : nullptr,
             [this]([[maybe_unused]] view::LiteralBackendView const &literal_view) {
-                // TODO: actually use LiteralType (therefore, we will need literal_view)
-                return identifier::NodeID{next_literal_id++, identifier::LiteralType::OTHER};
+                // typed values that fit into the NodeID never get here, see InlinedLiteral::id_of
+                return identifier::NodeID{LiteralID{store_->next_literal_id.fetch_add(1)}, identifier::LiteralType::OTHER};
             });
 }
-identifier::NodeID MetallNodeStorageBackend::find_or_make_id(view::IRIBackendView const &view) noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_or_make_id(view::IRIBackendView const &view) noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<IRIBackend, true>(
-            view, iri_mutex_, iri_storage, iri_storage_reverse, alloc,
+            view, iri_locks_, store_->iri_storage, store_->iri_storage_reverse, store_->iri_arena, read_only_,
+            caches != nullptr ? &caches->iri : nullptr,
             [this]([[maybe_unused]] view::IRIBackendView const &view) {
-                return next_iri_id++;
+                return NodeID{store_->next_iri_id.fetch_add(1)};
             });
 }
 
-identifier::NodeID MetallNodeStorageBackend::find_or_make_id(view::BNodeBackendView const &view) noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_or_make_id(view::BNodeBackendView const &view) noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<BNodeBackend, true>(
-            view, bnode_mutex_, bnode_storage, bnode_storage_reverse, alloc,
+            view, bnode_locks_, store_->bnode_storage, store_->bnode_storage_reverse, store_->bnode_arena, read_only_,
+            caches != nullptr ? &caches->bnode : nullptr,
             [this]([[maybe_unused]] view::BNodeBackendView const &view) {
-                return next_bnode_id++;
+                return NodeID{store_->next_bnode_id.fetch_add(1)};
             });
 }
-identifier::NodeID MetallNodeStorageBackend::find_or_make_id(view::VariableBackendView const &view) noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_or_make_id(view::VariableBackendView const &view) noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<VariableBackend, true>(
-            view, variable_mutex_, variable_storage, variable_storage_reverse, alloc,
+            view, variable_locks_, store_->variable_storage, store_->variable_storage_reverse, store_->variable_arena, read_only_,
+            caches != nullptr ? &caches->variable : nullptr,
+            [this]([[maybe_unused]] view::VariableBackendView const &view) {
+                return NodeID{store_->next_variable_id.fetch_add(1)};
+            });
+}
+
+template<StoragePolicy Policy>
+std::vector<identifier::NodeID> BasicNodeStorageBackend<Policy>::find_or_make_ids(std::span<view::LiteralBackendView const> views) {
+    // only the literals that are not inlined go through the index
+    std::vector<identifier::NodeID> ids(views.size());
+    std::vector<view::LiteralBackendView> stored_views;
+    std::vector<size_t> stored_positions;
+    for (size_t i = 0; i < views.size(); ++i) {
+        ids[i] = InlinedLiteral::id_of(store_->inlined_datatype_ids, views[i]);
+        if (ids[i].null()) {
+            stored_views.push_back(views[i]);
+            stored_positions.push_back(i);
+        }
+    }
+
+    std::vector<identifier::NodeID> const stored_ids = bulk_lookup_or_insert_impl<LiteralBackend>(
+            std::span<view::LiteralBackendView const>{stored_views}, literal_locks_, store_->literal_storage, store_->literal_storage_reverse,
+            store_->literal_arena, read_only_,
+            [this]([[maybe_unused]] view::LiteralBackendView const &literal_view) {
+                return identifier::NodeID{LiteralID{store_->next_literal_id.fetch_add(1)}, identifier::LiteralType::OTHER};
+            });
+    for (size_t i = 0; i < stored_positions.size(); ++i)
+        ids[stored_positions[i]] = stored_ids[i];
+    return ids;
+}
+template<StoragePolicy Policy>
+std::vector<identifier::NodeID> BasicNodeStorageBackend<Policy>::find_or_make_ids(std::span<view::IRIBackendView const> views) {
+    return bulk_lookup_or_insert_impl<IRIBackend>(
+            views, iri_locks_, store_->iri_storage, store_->iri_storage_reverse, store_->iri_arena, read_only_,
+            [this]([[maybe_unused]] view::IRIBackendView const &view) {
+                return NodeID{store_->next_iri_id.fetch_add(1)};
+            });
+}
+template<StoragePolicy Policy>
+std::vector<identifier::NodeID> BasicNodeStorageBackend<Policy>::find_or_make_ids(std::span<view::BNodeBackendView const> views) {
+    return bulk_lookup_or_insert_impl<BNodeBackend>(
+            views, bnode_locks_, store_->bnode_storage, store_->bnode_storage_reverse, store_->bnode_arena, read_only_,
+            [this]([[maybe_unused]] view::BNodeBackendView const &view) {
+                return NodeID{store_->next_bnode_id.fetch_add(1)};
+            });
+}
+template<StoragePolicy Policy>
+std::vector<identifier::NodeID> BasicNodeStorageBackend<Policy>::find_or_make_ids(std::span<view::VariableBackendView const> views) {
+    return bulk_lookup_or_insert_impl<VariableBackend>(
+            views, variable_locks_, store_->variable_storage, store_->variable_storage_reverse, store_->variable_arena, read_only_,
             [this]([[maybe_unused]] view::VariableBackendView const &view) {
-                return next_variable_id++;
+                return NodeID{store_->next_variable_id.fetch_add(1)};
             });
 }
 
-identifier::NodeID MetallNodeStorageBackend::find_id(const view::BNodeBackendView &view) const noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_id(const view::BNodeBackendView &view) const noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<BNodeBackend, false>(
-            view, bnode_mutex_, bnode_storage, bnode_storage_reverse, alloc);
+            view, bnode_locks_, store_->bnode_storage, store_->bnode_storage_reverse, store_->bnode_arena, read_only_,
+            caches != nullptr ? &caches->bnode : nullptr);
 }
-identifier::NodeID MetallNodeStorageBackend::find_id(const view::IRIBackendView &view) const noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_id(const view::IRIBackendView &view) const noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<IRIBackend, false>(
-            view, iri_mutex_, iri_storage, iri_storage_reverse, alloc);
+            view, iri_locks_, store_->iri_storage, store_->iri_storage_reverse, store_->iri_arena, read_only_,
+            caches != nullptr ? &caches->iri : nullptr);
 }
-identifier::NodeID MetallNodeStorageBackend::find_id(const view::LiteralBackendView &view) const noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_id(const view::LiteralBackendView &view) const noexcept {
+    if (identifier::NodeID const inlined = InlinedLiteral::id_of(store_->inlined_datatype_ids, view); !inlined.null())
+        return inlined;
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<LiteralBackend, false>(
-            view, literal_mutex_, literal_storage, literal_storage_reverse, alloc);
+            view, literal_locks_, store_->literal_storage, store_->literal_storage_reverse, store_->literal_arena, read_only_,
+            caches != nullptr ? &caches->literal : nullptr);
 }
-identifier::NodeID MetallNodeStorageBackend::find_id(const view::VariableBackendView &view) const noexcept {
+template<StoragePolicy Policy>
+identifier::NodeID BasicNodeStorageBackend<Policy>::find_id(const view::VariableBackendView &view) const noexcept {
+    ThreadFrontCaches *caches = front_caches_of(instance_id_, front_cache_enabled_);
     return lookup_or_insert_impl<VariableBackend, false>(
-            view, variable_mutex_, variable_storage, variable_storage_reverse, alloc);
+            view, variable_locks_, store_->variable_storage, store_->variable_storage_reverse, store_->variable_arena, read_only_,
+            caches != nullptr ? &caches->variable : nullptr);
 }
 
-view::IRIBackendView MetallNodeStorageBackend::find_iri_backend_view(identifier::NodeID id) const {
-    std::shared_lock<std::shared_mutex> shared_lock{iri_mutex_};
-    return view::IRIBackendView(*iri_storage->at(id));
+template<StoragePolicy Policy>
+view::LiteralBackendView BasicNodeStorageBackend<Policy>::inlined_literal_view(InlinedDatatype datatype, std::string_view lexical_form) const noexcept {
+    return {.datatype_id = store_->inlined_datatype_ids[InlinedLiteral::index_of(datatype)],
+            .lexical_form = lexical_form,
+            .language_tag = ""};
 }
-view::LiteralBackendView MetallNodeStorageBackend::find_literal_backend_view(identifier::NodeID id) const {
-    std::shared_lock<std::shared_mutex> shared_lock{literal_mutex_};
-    return view::LiteralBackendView(*literal_storage->at(id));
+
+template<StoragePolicy Policy>
+FrontCacheStats BasicNodeStorageBackend<Policy>::front_cache_stats() noexcept {
+    ThreadFrontCaches const &caches = thread_front_caches;
+    FrontCacheStats stats = caches.literal.stats();
+    stats += caches.bnode.stats();
+    stats += caches.iri.stats();
+    stats += caches.variable.stats();
+    return stats;
 }
-view::BNodeBackendView MetallNodeStorageBackend::find_bnode_backend_view(identifier::NodeID id) const {
-    std::shared_lock<std::shared_mutex> shared_lock{bnode_mutex_};
-    return view::BNodeBackendView(*bnode_storage->at(id));
+
+template<StoragePolicy Policy>
+view::IRIBackendView BasicNodeStorageBackend<Policy>::find_iri_backend_view(identifier::NodeID id) const {
+    IRIBackend const &record = store_->iri_storage->at(id);
+    if (record.contiguous()) {
+        std::string unused;
+        view::IRIBackendView const view = record.view(*store_->iri_arena, unused);
+        check_view(view.identifier, ViewLifetime::mapping);
+        return view;
+    }
+    std::string_view const identifier = decoded_iris_.find_or_decode(id.value(), [&](std::string &buffer) {
+        return record.view(*store_->iri_arena, buffer).identifier;
+    });
+    check_view(identifier, ViewLifetime::backend);
+    return {.identifier = identifier};
 }
-view::VariableBackendView MetallNodeStorageBackend::find_variable_backend_view(identifier::NodeID id) const {
-    std::shared_lock<std::shared_mutex> shared_lock{variable_mutex_};
-    return view::VariableBackendView(*variable_storage->at(id));
+template<StoragePolicy Policy>
+view::IRIBackendView BasicNodeStorageBackend<Policy>::find_iri_backend_view(identifier::NodeID id, std::string &buffer) const {
+    return store_->iri_storage->at(id).view(*store_->iri_arena, buffer);
 }
-bool MetallNodeStorageBackend::erase_iri([[maybe_unused]] identifier::NodeID id) const {
-    throw std::runtime_error("Deleting nodes is not implemented in MetallNodeStorageBackend.");
+template<StoragePolicy Policy>
+view::LiteralBackendView BasicNodeStorageBackend<Policy>::find_literal_backend_view(identifier::NodeID id) const {
+    if (auto const datatype = InlinedLiteral::datatype_of(id.literal_type()); datatype.has_value()) {
+        std::string_view const lexical_form = decoded_literals_.find_or_decode(id.value(), [&](std::string &buffer) -> std::string_view {
+            buffer = InlinedLiteral::decode(*datatype, id.literal_id().value);
+            return buffer;
+        });
+        check_view(lexical_form, ViewLifetime::backend);
+        return inlined_literal_view(*datatype, lexical_form);
+    }
+    view::LiteralBackendView const view = store_->literal_storage->at(id).view(*store_->literal_arena);
+    check_view(view.lexical_form, ViewLifetime::mapping);
+    check_view(view.language_tag, ViewLifetime::mapping);
+    return view;
 }
-bool MetallNodeStorageBackend::erase_literal([[maybe_unused]] identifier::NodeID id) const {
-    throw std::runtime_error("Deleting nodes is not implemented in MetallNodeStorageBackend.");
+template<StoragePolicy Policy>
+view::LiteralBackendView BasicNodeStorageBackend<Policy>::find_literal_backend_view(identifier::NodeID id, std::string &buffer) const {
+    if (auto const datatype = InlinedLiteral::datatype_of(id.literal_type()); datatype.has_value()) {
+        buffer = InlinedLiteral::decode(*datatype, id.literal_id().value);
+        return inlined_literal_view(*datatype, buffer);
+    }
+    return store_->literal_storage->at(id).view(*store_->literal_arena);
 }
-bool MetallNodeStorageBackend::erase_bnode([[maybe_unused]] identifier::NodeID id) const {
-    throw std::runtime_error("Deleting nodes is not implemented in MetallNodeStorageBackend.");
+template<StoragePolicy Policy>
+view::BNodeBackendView BasicNodeStorageBackend<Policy>::find_bnode_backend_view(identifier::NodeID id) const {
+    view::BNodeBackendView const view = store_->bnode_storage->at(id).view(*store_->bnode_arena);
+    check_view(view.identifier, ViewLifetime::mapping);
+    return view;
 }
-bool MetallNodeStorageBackend::erase_variable([[maybe_unused]] identifier::NodeID id) const {
-    throw std::runtime_error("Deleting nodes is not implemented in MetallNodeStorageBackend.");
+template<StoragePolicy Policy>
+view::VariableBackendView BasicNodeStorageBackend<Policy>::find_variable_backend_view(identifier::NodeID id) const {
+    view::VariableBackendView const view = store_->variable_storage->at(id).view(*store_->variable_arena);
+    check_view(view.name, ViewLifetime::mapping);
+    return view;
 }
+
+template<StoragePolicy Policy>
+std::vector<std::string_view> BasicNodeStorageBackend<Policy>::materialize(std::span<identifier::NodeID const> ids,
+                                                                    std::span<identifier::RDFNodeType const> types,
+                                                                    std::string &out) const {
+    using identifier::RDFNodeType;
+    if (ids.size() != types.size())
+        throw std::invalid_argument("materialize needs one RDFNodeType per NodeID.");
+
+    constexpr size_t prefetch_distance = 8;
+
+    // input positions of the ids, grouped by node type
+    std::array<std::vector<size_t>, 4> groups;
+    for (size_t i = 0; i < ids.size(); ++i)
+        groups[static_cast<size_t>(types[i])].push_back(i);
+
+    // offset and length of each term in out
+    std::vector<std::pair<size_t, size_t>> terms(ids.size());
+    auto write_group = [&](RDFNodeType type, auto const &storage, auto const &write_term) {
+        std::vector<size_t> const &group = groups[static_cast<size_t>(type)];
+        for (size_t k = 0; k < group.size(); ++k) {
+            if (k + prefetch_distance < group.size())
+                storage.prefetch(ids[group[k + prefetch_distance]]);
+            size_t const start = out.size();
+            write_term(ids[group[k]]);
+            terms[group[k]] = {start, out.size() - start};
+        }
+    };
+
+    std::string buffer;
+    auto append_iri = [&](identifier::NodeID id) {
+        out += '<';
+        out += store_->iri_storage->at(id).identifier(*store_->iri_arena, buffer);
+        out += '>';
+    };
+
+    write_group(RDFNodeType::IRI, *store_->iri_storage, append_iri);
+    write_group(RDFNodeType::BNode, *store_->bnode_storage, [&](identifier::NodeID id) {
+        out += "_:";
+        out += store_->bnode_storage->at(id).identifier(*store_->bnode_arena);
+    });
+    write_group(RDFNodeType::Variable, *store_->variable_storage, [&](identifier::NodeID id) {
+        VariableBackend const &record = store_->variable_storage->at(id);
+        out += record.is_anonymous() ? "_:" : "?";
+        out += record.name(*store_->variable_arena);
+    });
+    write_group(RDFNodeType::Literal, *store_->literal_storage, [&](identifier::NodeID id) {
+        if (auto const datatype = InlinedLiteral::datatype_of(id.literal_type()); datatype.has_value()) {
+            LiteralBackend::quote_lexical(InlinedLiteral::decode(*datatype, id.literal_id().value), out);
+            out += "^^";
+            append_iri(store_->inlined_datatype_ids[InlinedLiteral::index_of(*datatype)]);
+            return;
+        }
+        LiteralBackend const &record = store_->literal_storage->at(id);
+        LiteralBackend::quote_lexical(record.lexical_form(*store_->literal_arena), out);
+        if (std::string_view const language_tag = record.language_tag(*store_->literal_arena); !language_tag.empty()) {
+            out += '@';
+            out += language_tag;
+        } else if (record.datatype_id() != identifier::NodeID::xsd_string_iri.first) {
+            out += "^^";
+            append_iri(record.datatype_id());
+        }
+    });
+
+    std::vector<std::string_view> views;
+    views.reserve(terms.size());
+    for (auto const &[offset, length] : terms)
+        views.emplace_back(out.data() + offset, length);
+    return views;
+}
+
+template<StoragePolicy Policy>
+ViewLifetime BasicNodeStorageBackend<Policy>::iri_view_lifetime(identifier::NodeID id) const {
+    return store_->iri_storage->at(id).contiguous() ? ViewLifetime::mapping : ViewLifetime::backend;
+}
+template<StoragePolicy Policy>
+ViewLifetime BasicNodeStorageBackend<Policy>::literal_view_lifetime(identifier::NodeID id) noexcept {
+    return InlinedLiteral::datatype_of(id.literal_type()).has_value() ? ViewLifetime::backend : ViewLifetime::mapping;
+}
+
+template<StoragePolicy Policy>
+size_t BasicNodeStorageBackend<Policy>::verify_views() const {
+#ifdef METALL_NODE_STORAGE_DEBUG_VIEWS
+    return view_checker_.verify();
+#else
+    return 0;
+#endif
+}
+
+template<class Locks_t, class StoragePtr_t, class ReverseStoragePtr_t, class ArenaPtr_t>
+inline NodeTypeStats node_type_stats(Locks_t &locks, const StoragePtr_t &storage,
+                                     const ReverseStoragePtr_t &reverse_storage, const ArenaPtr_t &arena) {
+    NodeTypeStats stats;
+    uint64_t capacity = 0;
+    for (size_t stripe = 0; stripe < reverse_storage->stripe_count(); ++stripe) {
+        std::shared_lock<std::shared_mutex> shared_lock{locks.stripes[stripe].mutex};
+        auto const &index = reverse_storage->stripe(stripe);
+        stats.count += index.size();
+        stats.index_bytes += index.bytes();
+        capacity += index.capacity();
+        stats.max_stripe_load_factor = std::max(stats.max_stripe_load_factor, index.load_factor());
+    }
+    stats.index_load_factor = capacity == 0 ? 0 : static_cast<double>(stats.count) / static_cast<double>(capacity);
+    stats.erased = storage->erased_count();
+    stats.lock_contentions = locks.contended();
+
+    stats.string_bytes = arena->string_bytes();
+    uint64_t const string_count = arena->string_count();
+    stats.average_string_length = string_count == 0 ? 0 : static_cast<double>(stats.string_bytes) / static_cast<double>(string_count);
+
+    stats.forward_bytes_reserved = storage->bytes_reserved();
+    stats.forward_bytes_used = storage->bytes_used();
+    stats.arena_bytes_reserved = arena->bytes_reserved();
+    stats.arena_bytes_used = arena->bytes_used();
+    return stats;
+}
+
+template<StoragePolicy Policy>
+StorageStats BasicNodeStorageBackend<Policy>::stats() const {
+    StorageStats stats{
+            .literal = node_type_stats(literal_locks_, store_->literal_storage, store_->literal_storage_reverse, store_->literal_arena),
+            .bnode = node_type_stats(bnode_locks_, store_->bnode_storage, store_->bnode_storage_reverse, store_->bnode_arena),
+            .iri = node_type_stats(iri_locks_, store_->iri_storage, store_->iri_storage_reverse, store_->iri_arena),
+            .variable = node_type_stats(variable_locks_, store_->variable_storage, store_->variable_storage_reverse, store_->variable_arena),
+    };
+    stats.literal.decoded_bytes_reserved = decoded_literals_.bytes_reserved();
+    stats.iri.decoded_bytes_reserved = decoded_iris_.bytes_reserved();
+    stats.iri_prefixes = store_->iri_arena->prefix_count();
+    stats.language_tags = store_->literal_arena->language_tag_count();
+    return stats;
+}
+
+template<StoragePolicy Policy>
+std::shared_ptr<SortedIRIIndex<Policy> const> BasicNodeStorageBackend<Policy>::sorted_iris() const {
+    std::lock_guard<std::mutex> lock{sorted_iris_mutex_};
+    if (sorted_iris_ == nullptr || sorted_iris_->stale()) {
+        auto const locks = pause_writers();
+        sorted_iris_ = std::make_shared<SortedIRIIndex<Policy> const>(*store_->iri_storage, *store_->iri_arena, decoded_iris_);
+    }
+    return sorted_iris_;
+}
+
+template<StoragePolicy Policy>
+uint64_t BasicNodeStorageBackend<Policy>::arena_bytes_used() const noexcept {
+    return store_->literal_arena->bytes_used() + store_->bnode_arena->bytes_used() +
+           store_->iri_arena->bytes_used() + store_->variable_arena->bytes_used();
+}
+
+template<StoragePolicy Policy>
+std::vector<std::unique_lock<std::shared_mutex>> BasicNodeStorageBackend<Policy>::pause_writers() const {
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    for (NodeTypeLocks *type_locks : {&literal_locks_, &bnode_locks_, &iri_locks_, &variable_locks_}) {
+        for (size_t i = 0; i < type_locks->stripe_count; ++i)
+            locks.emplace_back(type_locks->stripes[i].mutex);
+    }
+    return locks;
+}
+
+template<StoragePolicy Policy>
+CheckpointStats BasicNodeStorageBackend<Policy>::snapshot(char const *destination_path) {
+    using clock = std::chrono::steady_clock;
+    auto const start = clock::now();
+    CheckpointStats stats;
+    {
+        auto const locks = pause_writers();
+        auto const paused = clock::now();
+        if (!manager_->snapshot(destination_path))
+            throw std::runtime_error("Could not write a snapshot to " + std::string{destination_path} + ".");
+        verify_views();
+        checkpoint_arena_bytes_ = arena_bytes_used();
+        stats.pause = clock::now() - paused;
+    }
+    stats.duration = clock::now() - start;
+    stats.snapshot_bytes = apparent_size(destination_path);
+    stats.reflinked = shares_extents(destination_path);
+    return stats;
+}
+
+template<StoragePolicy Policy>
+CheckpointStats BasicNodeStorageBackend<Policy>::flush() {
+    using clock = std::chrono::steady_clock;
+    auto const start = clock::now();
+    CheckpointStats stats;
+    {
+        auto const locks = pause_writers();
+        auto const paused = clock::now();
+        if (!manager_->flush())
+            throw std::runtime_error("Could not flush the datastore.");
+        verify_views();
+        uint64_t const arena_bytes = arena_bytes_used();
+        stats.arena_bytes_added = arena_bytes - checkpoint_arena_bytes_;
+        checkpoint_arena_bytes_ = arena_bytes;
+        stats.pause = clock::now() - paused;
+    }
+    stats.duration = clock::now() - start;
+    return stats;
+}
+
+template<StoragePolicy Policy>
+CompactionResult BasicNodeStorageBackend<Policy>::compact_into(metall::manager &target, CompactionOptions const &options, char const *store_name) const {
+    auto const locks = pause_writers();
+    return compact(*store_, target, store_name, options);
+}
+
+template<StoragePolicy Policy>
+FrozenImageResult BasicNodeStorageBackend<Policy>::export_frozen_image(char const *path, FrozenImageOptions const &options) const {
+    auto const locks = pause_writers();
+    return metall_node_storage::export_frozen_image(*store_, path, options);
+}
+
+template<StoragePolicy Policy>
+bool BasicNodeStorageBackend<Policy>::erase_iri(identifier::NodeID id) const {
+    // the predefined IRIs and the inlined datatypes are part of every store
+    for (const auto &[predefined_id, iri] : NodeID::predefined_iris) {
+        if (id == predefined_id)
+            return false;
+    }
+    if (std::find(store_->inlined_datatype_ids.begin(), store_->inlined_datatype_ids.end(), id) != store_->inlined_datatype_ids.end())
+        return false;
+    return erase_impl(id, iri_locks_, store_->iri_storage, store_->iri_storage_reverse, read_only_);
+}
+template<StoragePolicy Policy>
+bool BasicNodeStorageBackend<Policy>::erase_literal(identifier::NodeID id) const {
+    // inlined literals have nothing to erase
+    if (id.literal_type() != identifier::LiteralType::OTHER)
+        return false;
+    return erase_impl(id, literal_locks_, store_->literal_storage, store_->literal_storage_reverse, read_only_);
+}
+template<StoragePolicy Policy>
+bool BasicNodeStorageBackend<Policy>::erase_bnode(identifier::NodeID id) const {
+    return erase_impl(id, bnode_locks_, store_->bnode_storage, store_->bnode_storage_reverse, read_only_);
+}
+template<StoragePolicy Policy>
+bool BasicNodeStorageBackend<Policy>::erase_variable(identifier::NodeID id) const {
+    return erase_impl(id, variable_locks_, store_->variable_storage, store_->variable_storage_reverse, read_only_);
+}
+
+template class BasicNodeStorageBackend<MetallPolicy>;
+template class BasicNodeStorageBackend<HeapPolicy>;
 }  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -4,63 +4,262 @@
 #include <metall/metall.hpp>
 
 #include <rdf4cpp/rdf/storage/node/INodeStorageBackend.hpp>
+#include <rdf4cpp/rdf/storage/node/identifier/RDFNodeType.hpp>
 
-#include "BNodeBackend.hpp"
-#include "IRIBackend.hpp"
-#include "LiteralBackend.hpp"
-#include "VariableBackend.hpp"
+#include "Compaction.hpp"
+#include "DecodedStrings.hpp"
+#include "FrontCache.hpp"
+#include "FrozenImage.hpp"
+#include "MappingOptions.hpp"
+#include "MetallNodeStore.hpp"
+#include "SortedIRIIndex.hpp"
+#include "StoragePolicy.hpp"
+#include "StorageStats.hpp"
+#include "ViewChecker.hpp"
+#include "WarmUp.hpp"
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <concepts>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
-
-#include <metall/container/map.hpp>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
 /**
- * Thread-safe reference implementation of a INodeStorageBackend. Deleting nodes is not supported.
+ * How long the string_views in a backend view stay valid.
+ *
+ * Stored strings are never moved or overwritten: arenas are append-only, erase only leaves a tombstone,
+ * and compaction copies into another store. Views of them point straight into the mapped datastore.
+ * Nodes without a contiguous record, i.e. IRIs stored with a prefix and inlined literals, are decoded once into the
+ * DecodedStrings of the backend. No view is tied to the calling thread.
+ */
+enum struct ViewLifetime {
+    /**
+     * Valid as long as the datastore is mapped, even after the backend was destroyed. For HeapPolicy, as long as its HeapManager exists.
+     */
+    mapping,
+    /**
+     * Valid as long as the backend that returned the view exists.
+     */
+    backend,
+};
+
+/**
+ * Timing and size of a snapshot or flush.
+ */
+struct CheckpointStats {
+    /**
+     * Time during which writers were blocked. For a snapshot this includes the whole copy, see reflinked.
+     */
+    std::chrono::nanoseconds pause{};
+    std::chrono::nanoseconds duration{};
+    /**
+     * snapshot: apparent size of the snapshot.
+     */
+    uint64_t snapshot_bytes = 0;
+    /**
+     * snapshot: true if the files of the snapshot share their extents with the datastore, i.e. they were reflinked and
+     * the pause only covered cloning metadata. Otherwise all snapshot_bytes were copied while writers were paused.
+     */
+    bool reflinked = false;
+    /**
+     * flush: string bytes added to the arenas since the previous snapshot or flush. Not the bytes written back:
+     * new forward and index entries dirty pages as well, and a page is written back whole.
+     */
+    uint64_t arena_bytes_added = 0;
+};
+
+/**
+ * Thread-safe reference implementation of a INodeStorageBackend.
+ * Erased nodes leave a tombstone in the forward table and are removed from the reverse index. Their space is reclaimed by compact_into.
+ * The reverse index of each node type is striped by hash, so that concurrent inserts only contend when they hit the same stripe.
+ * Forward lookups (find_*_backend_view) are lock-free.
+ * Literals of the InlinedLiteral datatypes are encoded in their NodeID and not stored at all.
+ * IRIs are stored as a shared namespace prefix plus suffix, see PrefixedStringArena.
+ * find_id and find_or_make_id first consult a small per-thread FrontCache, which serves hot terms without touching the index.
+ * The nodes are kept in a BasicNodeStore inside the datastore of Policy, see StoragePolicy.hpp: a Metall datastore
+ * for MetallNodeStorageBackend, the heap for InMemoryNodeStorageBackend. This object only holds the process-local state
+ * and is cheap to create: attaching to an existing datastore does not rebuild anything.
+ *
+ * Views returned by find_*_backend_view never need to be copied, see ViewLifetime for how long they stay valid.
+ * Building with METALL_NODE_STORAGE_DEBUG_VIEWS checks every returned view against that contract.
  */
-class MetallNodeStorageBackend : public INodeStorageBackend {
+template<StoragePolicy Policy>
+class BasicNodeStorageBackend : public INodeStorageBackend {
 public:
     using NodeID = identifier::NodeID;
     using LiteralID = identifier::LiteralID;
-    using Alloc = metall::manager::allocator_type<std::byte>;
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+    using Manager = typename Policy::manager_type;
+
+    static constexpr char const *default_store_name = "node_store";
 
 private:
-    mutable std::shared_mutex literal_mutex_;
-    metall::offset_ptr<typename metall::container::map<NodeID,typename metall::offset_ptr<LiteralBackend>, std::less<>>> literal_storage;
-    metall::offset_ptr<typename metall::container::map<typename metall::offset_ptr<LiteralBackend>, NodeID, std::less<>>> literal_storage_reverse;
-    mutable std::shared_mutex bnode_mutex_;
-    metall::offset_ptr<typename metall::container::map<NodeID,typename metall::offset_ptr<BNodeBackend>, std::less<>>> bnode_storage;
-    metall::offset_ptr<typename metall::container::map<typename metall::offset_ptr<BNodeBackend>, NodeID, std::less<>>> bnode_storage_reverse;
-    mutable std::shared_mutex iri_mutex_;
-    metall::offset_ptr<typename metall::container::map<NodeID,typename metall::offset_ptr<IRIBackend>, std::less<>>> iri_storage;
-    metall::offset_ptr<typename metall::container::map<typename metall::offset_ptr<IRIBackend>, NodeID, std::less<>>> iri_storage_reverse;
-    mutable std::shared_mutex variable_mutex_;
-    metall::offset_ptr<typename metall::container::map<NodeID,typename metall::offset_ptr<VariableBackend>, std::less<>>> variable_storage;
-    metall::offset_ptr<typename metall::container::map<typename metall::offset_ptr<VariableBackend>, NodeID, std::less<>>> variable_storage_reverse;
-
-    Alloc alloc;
-
-    LiteralID next_literal_id = NodeID::min_literal_id;
-    NodeID next_bnode_id = NodeID::min_bnode_id;
-    NodeID next_iri_id = NodeID::min_iri_id;
-    NodeID next_variable_id = NodeID::min_variable_id;
+    /**
+     * Process-local locks of one node type. stripes[i] guards stripe i of the reverse index.
+     * The forward table needs no lock, see DenseIDTable.
+     */
+    struct NodeTypeLocks {
+        struct alignas(64) Stripe {
+            std::shared_mutex mutex;
+            /**
+             * Acquisitions that had to wait for another thread.
+             */
+            std::atomic<uint64_t> contended = 0;
+        };
+
+        std::unique_ptr<Stripe[]> stripes;
+        size_t stripe_count;
+
+        explicit NodeTypeLocks(size_t stripe_count) : stripes(std::make_unique<Stripe[]>(stripe_count)), stripe_count(stripe_count) {}
+
+        [[nodiscard]] std::shared_lock<std::shared_mutex> shared(size_t stripe) {
+            std::shared_lock<std::shared_mutex> lock{stripes[stripe].mutex, std::try_to_lock};
+            if (!lock.owns_lock()) {
+                stripes[stripe].contended.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            return lock;
+        }
+
+        [[nodiscard]] std::unique_lock<std::shared_mutex> exclusive(size_t stripe) {
+            std::unique_lock<std::shared_mutex> lock{stripes[stripe].mutex, std::try_to_lock};
+            if (!lock.owns_lock()) {
+                stripes[stripe].contended.fetch_add(1, std::memory_order_relaxed);
+                lock.lock();
+            }
+            return lock;
+        }
+
+        [[nodiscard]] uint64_t contended() const noexcept {
+            uint64_t n = 0;
+            for (size_t i = 0; i < stripe_count; ++i)
+                n += stripes[i].contended.load(std::memory_order_relaxed);
+            return n;
+        }
+    };
+
+    Manager *manager_;
+    BasicNodeStore<Policy> *store_;
+    bool read_only_;
+    /**
+     * Identifies this backend to the per-thread front caches. Unlike the address, it is never reused.
+     */
+    uint64_t instance_id_;
+    bool front_cache_enabled_ = true;
+
+    /**
+     * Inlined literals have no record in the datastore, lexical_form is their decoded NodeID.
+     */
+    [[nodiscard]] view::LiteralBackendView inlined_literal_view(InlinedDatatype datatype, std::string_view lexical_form) const noexcept;
+
+    /**
+     * IRIs stored with a prefix, rebuilt by find_iri_backend_view.
+     */
+    mutable DecodedStrings decoded_iris_;
+    /**
+     * Lexical forms of inlined literals, decoded by find_literal_backend_view.
+     */
+    mutable DecodedStrings decoded_literals_;
+
+    /**
+     * Built by the first call to sorted_iris and replaced once it is stale.
+     */
+    mutable std::mutex sorted_iris_mutex_;
+    mutable std::shared_ptr<SortedIRIIndex<Policy> const> sorted_iris_;
+
+    [[nodiscard]] uint64_t arena_bytes_used() const noexcept;
+
+    /**
+     * Blocks all writers by taking every stripe lock exclusively. Lookups that miss the front cache block as well.
+     * Writers hold at most one stripe lock at a time, so taking all of them in a fixed order cannot deadlock.
+     * Writers only allocate in the datastore while they hold a stripe lock, so nothing is allocated while paused.
+     */
+    [[nodiscard]] std::vector<std::unique_lock<std::shared_mutex>> pause_writers() const;
+
+    mutable NodeTypeLocks literal_locks_;
+    mutable NodeTypeLocks bnode_locks_;
+    mutable NodeTypeLocks iri_locks_;
+    mutable NodeTypeLocks variable_locks_;
+
+    /**
+     * Arena bytes in use at the last snapshot or flush.
+     */
+    uint64_t checkpoint_arena_bytes_;
+
+#ifdef METALL_NODE_STORAGE_DEBUG_VIEWS
+    mutable ViewChecker view_checker_;
+#endif
+
+    /**
+     * Hands str to the ViewChecker in debug builds, does nothing otherwise.
+     */
+    void check_view([[maybe_unused]] std::string_view str, [[maybe_unused]] ViewLifetime lifetime) const {
+#ifdef METALL_NODE_STORAGE_DEBUG_VIEWS
+        view_checker_.record(str, lifetime == ViewLifetime::mapping);
+#endif
+    }
 
 public:
-    explicit MetallNodeStorageBackend(const Alloc &al);
+    /**
+     * Attaches to the BasicNodeStore named store_name in manager, or creates it if it does not exist yet.
+     * If manager was opened read-only, the store must exist and find_or_make_id will not add new nodes.
+     * @throws std::runtime_error if the store is missing from a read-only datastore or has an incompatible format
+     */
+    explicit BasicNodeStorageBackend(Manager &manager, char const *store_name = default_store_name);
+
+    /**
+     * Attaches like the constructor above and applies options with advise.
+     */
+    BasicNodeStorageBackend(Manager &manager, MappingOptions const &options, char const *store_name = default_store_name);
+
+    ~BasicNodeStorageBackend() override = default;
+
+    /**
+     * Applies placement hints to the datastore mapping, e.g. AccessPattern::sequential before a bulk load
+     * and AccessPattern::random once it serves lookups. May be called again at any time.
+     * interleave_index only takes effect for InMemoryNodeStorageBackend, a Metall datastore is a file mapping, see interleave_numa.
+     * The NUMA policy of the reverse indexes covers their current tables. Tables that grow later are allocated anew,
+     * so call this again after a bulk load.
+     * @return false if the kernel rejected any of the hints, the others are applied anyway
+     */
+    bool advise(MappingOptions const &options) const;
+
+    /**
+     * Starts loading the datastore into memory in the background: the reverse indexes first, then the forward tables,
+     * then the strings, up to options.memory_budget bytes. The backend serves requests meanwhile.
+     * Index tables that grow while loading are only loaded at their old address, which stays mapped as part of the datastore.
+     * The returned WarmUp must be destroyed before the backend.
+     * Only for MetallPolicy: a HeapPolicy store is in memory already, and the heap may unmap the old memory of a grown table.
+     */
+    [[nodiscard]] std::unique_ptr<WarmUp> warm_up(WarmUpOptions options = {}) const
+        requires std::same_as<Policy, MetallPolicy>;
 
-    ~MetallNodeStorageBackend() override = default;
+    [[nodiscard]] bool read_only() const noexcept {
+        return read_only_;
+    }
 
-//    Alloc& get_allocator(){
-//        return alloc;
-//    }
+    /**
+     * Enables or disables the per-thread front cache for all threads. It is enabled by default.
+     * Must not be called while other threads use this backend.
+     */
+    void front_cache_enabled(bool enabled) noexcept {
+        front_cache_enabled_ = enabled;
+    }
 
-//    const Alloc & get_allocator() const{
-//        return alloc;
-//    }
+    [[nodiscard]] bool front_cache_enabled() const noexcept {
+        return front_cache_enabled_;
+    }
+
+    /**
+     * Front cache hits and misses of the calling thread, summed over all node types and backends it used.
+     */
+    [[nodiscard]] static FrontCacheStats front_cache_stats() noexcept;
 
     [[nodiscard]] identifier::NodeID find_or_make_id(view::BNodeBackendView const &) noexcept override;
     [[nodiscard]] identifier::NodeID find_or_make_id(view::IRIBackendView const &) noexcept override;
@@ -72,16 +271,131 @@ public:
     [[nodiscard]] identifier::NodeID find_id(view::LiteralBackendView const &) const noexcept override;
     [[nodiscard]] identifier::NodeID find_id(view::VariableBackendView const &) const noexcept override;
 
+    /**
+     * Bulk version of find_or_make_id for loading large datasets.
+     * The batch is deduplicated and grouped by stripe of the reverse index, each stripe is locked once: exclusively to add
+     * the missing nodes, or shared if the datastore is read-only and nothing can be added.
+     * @return the NodeIDs in the order of the input views
+     */
+    [[nodiscard]] std::vector<identifier::NodeID> find_or_make_ids(std::span<view::BNodeBackendView const> views);
+    [[nodiscard]] std::vector<identifier::NodeID> find_or_make_ids(std::span<view::IRIBackendView const> views);
+    [[nodiscard]] std::vector<identifier::NodeID> find_or_make_ids(std::span<view::LiteralBackendView const> views);
+    [[nodiscard]] std::vector<identifier::NodeID> find_or_make_ids(std::span<view::VariableBackendView const> views);
+
+    /**
+     * IRIs stored with a prefix are rebuilt once and kept by the backend, see ViewLifetime::backend.
+     */
     [[nodiscard]] view::IRIBackendView find_iri_backend_view(identifier::NodeID id) const override;
+    /**
+     * Rebuilds the IRI into buffer if it is stored with a prefix. The view is valid until buffer is modified.
+     */
+    [[nodiscard]] view::IRIBackendView find_iri_backend_view(identifier::NodeID id, std::string &buffer) const;
+    /**
+     * Inlined literals are decoded once and kept by the backend, see ViewLifetime::backend.
+     */
     [[nodiscard]] view::LiteralBackendView find_literal_backend_view(identifier::NodeID id) const override;
+    /**
+     * Decodes an inlined literal into buffer, the view is valid until buffer is modified. Stored literals do not use buffer.
+     */
+    [[nodiscard]] view::LiteralBackendView find_literal_backend_view(identifier::NodeID id, std::string &buffer) const;
     [[nodiscard]] view::BNodeBackendView find_bnode_backend_view(identifier::NodeID id) const override;
     [[nodiscard]] view::VariableBackendView find_variable_backend_view(identifier::NodeID id) const override;
 
+    /**
+     * Writes the N-Triples form of many nodes into out, for serializing large results.
+     * The ids are processed grouped by node type, and the forward records are prefetched ahead of use.
+     * Stored literals of type xsd:string are written without a datatype, variables as ?name (anonymous ones as _:name).
+     * @param types node type of each id
+     * @param out the terms are appended to it
+     * @return the term of each id in input order, pointing into out and valid until out is modified
+     * @throws std::invalid_argument if ids and types differ in size
+     * @throws std::out_of_range if a node is not stored
+     */
+    [[nodiscard]] std::vector<std::string_view> materialize(std::span<identifier::NodeID const> ids,
+                                                            std::span<identifier::RDFNodeType const> types,
+                                                            std::string &out) const;
+
+    /**
+     * Lifetime of the views that find_iri_backend_view(id) returns: IRIs stored with a shared prefix are rebuilt
+     * into the backend, all others point into the mapping.
+     * @throws std::out_of_range if no IRI is stored for id
+     */
+    [[nodiscard]] ViewLifetime iri_view_lifetime(identifier::NodeID id) const;
+    /**
+     * Lifetime of the views that find_literal_backend_view(id) returns: inlined literals are decoded into the backend,
+     * stored literals point into the mapping. Views of blank nodes and variables always point into the mapping.
+     */
+    [[nodiscard]] static ViewLifetime literal_view_lifetime(identifier::NodeID id) noexcept;
+
+    /**
+     * Checks that the bytes behind all views returned so far are unchanged.
+     * Only does something if built with METALL_NODE_STORAGE_DEBUG_VIEWS, then it is also called by flush and snapshot.
+     * @return number of views checked
+     * @throws std::logic_error if a view was invalidated
+     */
+    size_t verify_views() const;
+
+    /**
+     * Sorted run of all stored IRIs for prefix and range scans, e.g.
+     * <code>auto const index = backend.sorted_iris(); for (auto [id, iri] : index->with_prefix("http://dbpedia.org/resource/"))</code>.
+     * It is built on the first call, which sorts all IRIs while writers are paused, and reused until IRIs are added or erased.
+     * The returned index is a snapshot, hold on to it for the duration of a scan. Its views live as long as the ones of find_iri_backend_view.
+     */
+    [[nodiscard]] std::shared_ptr<SortedIRIIndex<Policy> const> sorted_iris() const;
+
+    /**
+     * Memory and occupancy of the store, per node type. Cheap enough to be polled, it does not scan the forward tables.
+     */
+    [[nodiscard]] StorageStats stats() const;
+
+    /**
+     * Writes a crash-consistent copy of the whole datastore to destination_path through Metall's snapshot facility,
+     * which uses reflinks where the file system supports them. A HeapManager cannot take snapshots, use compact_into.
+     * Writers are paused while the copy is taken. Front cache hits and find_*_backend_view continue.
+     * With reflinks the pause is short. Without them it lasts for a full copy of the datastore, so writers block
+     * for as long as it takes to write every byte. CheckpointStats::reflinked tells which case happened.
+     * @throws std::runtime_error if the snapshot fails
+     */
+    CheckpointStats snapshot(char const *destination_path);
+
+    /**
+     * Writes the dirty pages of the datastore back to its files, so that the datastore survives a crash in this state.
+     * Writers are paused during the flush.
+     * @throws std::runtime_error if the flush fails
+     */
+    CheckpointStats flush();
+
+    /**
+     * Copies all nodes that were not erased into a new store in target, see compact().
+     * Also persists the nodes of an InMemoryNodeStorageBackend. Writers are paused during the copy.
+     */
+    CompactionResult compact_into(metall::manager &target, CompactionOptions const &options = {},
+                                  char const *store_name = default_store_name) const;
+
+    /**
+     * Writes all nodes that were not erased as a frozen image to path, see export_frozen_image.
+     * The image can be served by a FrozenNodeStorageBackend. Writers are paused during the export.
+     */
+    FrozenImageResult export_frozen_image(char const *path, FrozenImageOptions const &options = {}) const;
+
+    /**
+     * IDs are never reused. The predefined IRIs, the inlined datatype IRIs and inlined literals cannot be erased.
+     * @throws std::runtime_error if the datastore is read-only
+     */
     bool erase_iri(identifier::NodeID id) const override;
     bool erase_literal(identifier::NodeID id) const override;
     bool erase_bnode(identifier::NodeID id) const override;
     bool erase_variable(identifier::NodeID id) const override;
 };
 
+/**
+ * Nodes in a persistent Metall datastore.
+ */
+using MetallNodeStorageBackend = BasicNodeStorageBackend<MetallPolicy>;
+/**
+ * Nodes on the heap, for tests and ephemeral caches. Nothing survives the HeapManager.
+ */
+using InMemoryNodeStorageBackend = BasicNodeStorageBackend<HeapPolicy>;
+
 }  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
 #endif  //METALLNODESTORAGEBACKEND_HPP
@@ -0,0 +1,90 @@
+#include "MetallNodeStore.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Allocates and constructs the object that ptr points to with the allocator of the store.
+ */
+template<typename Pointer_t, typename Alloc, typename... Args>
+void construct_in(Pointer_t &ptr, Alloc const &alloc, Args &&...args) {
+    using AllocTraits = typename std::allocator_traits<Alloc>::template rebind_traits<typename std::pointer_traits<Pointer_t>::element_type>;
+    typename AllocTraits::allocator_type rebindAlloc = alloc;
+    ptr = AllocTraits::allocate(rebindAlloc, 1);
+    AllocTraits::construct(rebindAlloc, std::to_address(ptr), std::forward<Args>(args)...);
+}
+
+template<typename Pointer_t, typename Alloc>
+void destroy_in(Pointer_t &ptr, Alloc const &alloc) {
+    using AllocTraits = typename std::allocator_traits<Alloc>::template rebind_traits<typename std::pointer_traits<Pointer_t>::element_type>;
+    typename AllocTraits::allocator_type rebindAlloc = alloc;
+    AllocTraits::destroy(rebindAlloc, std::to_address(ptr));
+    AllocTraits::deallocate(rebindAlloc, ptr, 1);
+    ptr = nullptr;
+}
+
+template<typename StoragePtr_t, typename ReverseStoragePtr_t, typename ArenaPtr_t, typename Alloc>
+void initStorage(StoragePtr_t &ptrStorage, ReverseStoragePtr_t &ptrReverseStorage, ArenaPtr_t &ptrArena, const Alloc &alloc, uint64_t first_key) {
+    construct_in(ptrStorage, alloc, alloc, first_key);
+    construct_in(ptrReverseStorage, alloc, alloc);
+    construct_in(ptrArena, alloc, alloc);
+}
+
+template<StoragePolicy Policy>
+BasicNodeStore<Policy>::BasicNodeStore(const Alloc &alloc) : alloc_(alloc) {
+    // the predefined IRIs are placed below min_iri_id, the IRI table has to start at the smallest of them
+    uint64_t first_iri_key = NodeIDKey::of(NodeID{NodeID::min_iri_id});
+    for (const auto &[id, iri] : NodeID::predefined_iris)
+        first_iri_key = std::min(first_iri_key, NodeIDKey::of(id));
+
+    initStorage(literal_storage, literal_storage_reverse, literal_arena, alloc, LiteralID{NodeID::min_literal_id}.value);
+    initStorage(bnode_storage, bnode_storage_reverse, bnode_arena, alloc, NodeIDKey::of(NodeID{NodeID::min_bnode_id}));
+    initStorage(iri_storage, iri_storage_reverse, iri_arena, alloc, first_iri_key);
+    initStorage(variable_storage, variable_storage_reverse, variable_arena, alloc, NodeIDKey::of(NodeID{NodeID::min_variable_id}));
+
+    auto const add_iri = [this](NodeID id, std::string_view iri) {
+        uint64_t const hash = ViewHash{}(view::IRIBackendView{.identifier = iri});
+        iri_storage->insert(id, IRIBackend{*iri_arena, iri}, hash);
+        iri_storage_reverse->stripe(iri_storage_reverse->stripe_of(hash)).insert(hash, id);
+    };
+    for (const auto &[id, iri] : NodeID::predefined_iris)
+        add_iri(id, iri);
+    for (size_t i = 0; i < InlinedLiteral::datatype_count; ++i) {
+        inlined_datatype_ids[i] = NodeID{next_iri_id.fetch_add(1)};
+        add_iri(inlined_datatype_ids[i], InlinedLiteral::datatype_iris[i]);
+    }
+}
+
+template<StoragePolicy Policy>
+BasicNodeStore<Policy>::~BasicNodeStore() {
+    destroy_in(literal_storage, alloc_);
+    destroy_in(literal_storage_reverse, alloc_);
+    destroy_in(literal_arena, alloc_);
+    destroy_in(bnode_storage, alloc_);
+    destroy_in(bnode_storage_reverse, alloc_);
+    destroy_in(bnode_arena, alloc_);
+    destroy_in(iri_storage, alloc_);
+    destroy_in(iri_storage_reverse, alloc_);
+    destroy_in(iri_arena, alloc_);
+    destroy_in(variable_storage, alloc_);
+    destroy_in(variable_storage_reverse, alloc_);
+    destroy_in(variable_arena, alloc_);
+}
+
+template<StoragePolicy Policy>
+void BasicNodeStore<Policy>::validate() const {
+    if (magic_ != magic)
+        throw std::runtime_error("The datastore does not contain a MetallNodeStore.");
+    if (format_version_ != format_version)
+        throw std::runtime_error("MetallNodeStore format version " + std::to_string(format_version_) +
+                                 " is not supported, expected version " + std::to_string(format_version) + ".");
+}
+
+template struct BasicNodeStore<MetallPolicy>;
+template struct BasicNodeStore<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
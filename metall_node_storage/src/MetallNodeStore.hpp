@@ -0,0 +1,94 @@
+#ifndef METALL_METALLNODESTORE_HPP
+#define METALL_METALLNODESTORE_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include "BNodeBackend.hpp"
+#include "DenseIDTable.hpp"
+#include "HashIndex.hpp"
+#include "IRIBackend.hpp"
+#include "InlinedLiteral.hpp"
+#include "LiteralArena.hpp"
+#include "LiteralBackend.hpp"
+#include "PrefixedStringArena.hpp"
+#include "StoragePolicy.hpp"
+#include "StringArena.hpp"
+#include "VariableBackend.hpp"
+#include "ViewHash.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Persistent part of a BasicNodeStorageBackend, stored as a named object in the datastore of Policy.
+ * It holds only position-independent data. Locks, vtables and anything else process-local live in BasicNodeStorageBackend.
+ * That way a datastore written by one process can be attached by another without a rebuild.
+ */
+template<StoragePolicy Policy>
+struct BasicNodeStore {
+    using NodeID = identifier::NodeID;
+    using LiteralID = identifier::LiteralID;
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+    template<typename T>
+    using pointer = typename Policy::template pointer<T>;
+
+    static constexpr uint64_t magic = 0x5345444f4e4c544dULL;  // "MTLNODES"
+    /**
+     * Must be bumped whenever the layout of this struct or of anything it points to changes.
+     */
+    static constexpr uint32_t format_version = 11;
+
+    uint64_t magic_ = magic;
+    uint32_t format_version_ = format_version;
+    Alloc alloc_;
+
+    pointer<DenseIDTable<Policy, LiteralBackend, LiteralIDKey>> literal_storage;
+    pointer<StripedHashIndex<Policy>> literal_storage_reverse;
+    pointer<LiteralArena<Policy>> literal_arena;
+    pointer<DenseIDTable<Policy, BNodeBackend>> bnode_storage;
+    pointer<StripedHashIndex<Policy>> bnode_storage_reverse;
+    pointer<StringArena<Policy>> bnode_arena;
+    pointer<DenseIDTable<Policy, IRIBackend>> iri_storage;
+    pointer<StripedHashIndex<Policy>> iri_storage_reverse;
+    pointer<PrefixedStringArena<Policy>> iri_arena;
+    pointer<DenseIDTable<Policy, VariableBackend>> variable_storage;
+    pointer<StripedHashIndex<Policy>> variable_storage_reverse;
+    pointer<StringArena<Policy>> variable_arena;
+
+    /**
+     * ID counters, advanced with fetch_add so that stripes can allocate IDs without a common lock.
+     * Literals count LiteralIDs, the other node types NodeID values.
+     */
+    std::atomic<uint64_t> next_literal_id = LiteralID{NodeID::min_literal_id}.value;
+    std::atomic<uint64_t> next_bnode_id = NodeID{NodeID::min_bnode_id}.value();
+    std::atomic<uint64_t> next_iri_id = NodeID{NodeID::min_iri_id}.value();
+    std::atomic<uint64_t> next_variable_id = NodeID{NodeID::min_variable_id}.value();
+
+    /**
+     * IRI NodeIDs of the InlinedLiteral datatypes, indexed by InlinedLiteral::index_of. They are added when the store is created.
+     */
+    std::array<NodeID, InlinedLiteral::datatype_count> inlined_datatype_ids{};
+
+    explicit BasicNodeStore(const Alloc &alloc);
+    /**
+     * Frees all tables and arenas of the store.
+     */
+    ~BasicNodeStore();
+
+    BasicNodeStore(BasicNodeStore const &) = delete;
+    BasicNodeStore &operator=(BasicNodeStore const &) = delete;
+
+    /**
+     * @throws std::runtime_error if the header does not match this build
+     */
+    void validate() const;
+};
+
+using MetallNodeStore = BasicNodeStore<MetallPolicy>;
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_METALLNODESTORE_HPP
@@ -0,0 +1,203 @@
+#include "MinimalPerfectHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+namespace {
+/**
+ * Independent hash of hash for every pilot (splitmix64 finalizer).
+ */
+inline uint64_t mix(uint64_t hash, uint64_t pilot) noexcept {
+    uint64_t x = hash + (pilot + 1) * 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Maps hash uniformly to [0, n) without a division.
+ */
+inline uint64_t reduce(uint64_t hash, uint64_t n) noexcept {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * n) >> 64);
+}
+
+/**
+ * Hashes below this go to the dense buckets, the first 30% of all buckets.
+ */
+constexpr uint64_t dense_threshold = static_cast<uint64_t>(0.6 * 18446744073709551616.0);
+
+inline uint64_t dense_bucket_count(uint64_t bucket_count) noexcept {
+    return (bucket_count * 3 + 9) / 10;
+}
+}  // namespace
+
+MinimalPerfectHash::MinimalPerfectHash(std::span<uint64_t const> words) {
+    if (words.size() < header_words || words[0] != magic)
+        throw std::runtime_error("The data does not contain a MinimalPerfectHash.");
+    key_count_ = words[1];
+    placed_count_ = words[2];
+    bucket_count_ = words[3];
+    table_size_ = words[4];
+    fallback_count_ = words[5];
+    if (table_size_ < placed_count_ || placed_count_ + fallback_count_ != key_count_ || (placed_count_ != 0 && bucket_count_ < 2))
+        throw std::runtime_error("The MinimalPerfectHash is corrupt.");
+
+    uint64_t const *const pilot_words = words.data() + header_words;
+    pilots_ = reinterpret_cast<uint32_t const *>(pilot_words);
+    remap_ = pilot_words + (bucket_count_ + 1) / 2;
+    fallback_ = remap_ + (table_size_ - placed_count_);
+    if (bytes() > words.size_bytes())
+        throw std::runtime_error("The MinimalPerfectHash is truncated.");
+}
+
+uint64_t MinimalPerfectHash::bucket_of(uint64_t hash) const noexcept {
+    uint64_t const dense = dense_bucket_count(bucket_count_);
+    uint64_t const spread = hash * 0x9e3779b97f4a7c15ULL;
+    if (hash < dense_threshold)
+        return reduce(spread, dense);
+    return dense + reduce(spread, bucket_count_ - dense);
+}
+
+uint64_t MinimalPerfectHash::position_of(uint64_t hash, uint64_t pilot) const noexcept {
+    return reduce(mix(hash, pilot), table_size_);
+}
+
+std::pair<std::vector<uint64_t>, std::vector<uint64_t>> MinimalPerfectHash::build(std::span<uint64_t const> hashes) {
+    std::vector<size_t> by_hash(hashes.size());
+    for (size_t i = 0; i < by_hash.size(); ++i)
+        by_hash[i] = i;
+    std::sort(by_hash.begin(), by_hash.end(), [&hashes](size_t a, size_t b) {
+        return hashes[a] < hashes[b];
+    });
+
+    std::vector<size_t> unique;
+    std::vector<size_t> equal;
+    unique.reserve(hashes.size());
+    for (size_t i = 0; i < by_hash.size();) {
+        size_t j = i + 1;
+        while (j < by_hash.size() && hashes[by_hash[j]] == hashes[by_hash[i]])
+            ++j;
+        std::vector<size_t> &group = j - i == 1 ? unique : equal;
+        group.insert(group.end(), by_hash.begin() + static_cast<std::ptrdiff_t>(i), by_hash.begin() + static_cast<std::ptrdiff_t>(j));
+        i = j;
+    }
+
+    MinimalPerfectHash mph;
+    mph.key_count_ = hashes.size();
+    mph.placed_count_ = unique.size();
+    mph.fallback_count_ = equal.size();
+    if (!unique.empty()) {
+        auto const n = static_cast<double>(unique.size());
+        mph.table_size_ = std::max<uint64_t>(unique.size(), static_cast<uint64_t>(std::ceil(n / alpha)));
+        mph.bucket_count_ = std::max<uint64_t>(2, static_cast<uint64_t>(std::ceil(bucket_factor * n / std::log2(std::max(n, 2.0)))));
+    }
+
+    // keys by bucket, largest buckets first
+    std::vector<std::pair<uint64_t, size_t>> keys;
+    keys.reserve(unique.size());
+    for (size_t const i : unique)
+        keys.emplace_back(mph.bucket_of(hashes[i]), i);
+    std::sort(keys.begin(), keys.end());
+    std::vector<std::pair<size_t, size_t>> buckets;  // (first, last) in keys
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].first == keys[i].first)
+            ++j;
+        buckets.emplace_back(i, j);
+        i = j;
+    }
+    std::stable_sort(buckets.begin(), buckets.end(), [](auto const &a, auto const &b) {
+        return a.second - a.first > b.second - b.first;
+    });
+
+    std::vector<uint32_t> pilots(mph.bucket_count_, 0);
+    std::vector<bool> taken(mph.table_size_, false);
+    std::vector<uint64_t> positions(hashes.size());
+    std::vector<uint64_t> trial;
+    for (auto const &[first, last] : buckets) {
+        uint64_t pilot = 0;
+        for (;; ++pilot) {
+            if (pilot > UINT32_MAX)
+                throw std::runtime_error("Could not build a MinimalPerfectHash.");
+            trial.clear();
+            for (size_t k = first; k < last; ++k) {
+                uint64_t const position = mph.position_of(hashes[keys[k].second], pilot);
+                if (taken[position])
+                    break;
+                taken[position] = true;
+                trial.push_back(position);
+            }
+            if (trial.size() == last - first)
+                break;
+            for (uint64_t const position : trial)
+                taken[position] = false;
+        }
+        pilots[keys[first].first] = static_cast<uint32_t>(pilot);
+        for (size_t k = first; k < last; ++k)
+            positions[keys[k].second] = trial[k - first];
+    }
+
+    // positions past placed_count_ take the free ones below it in order
+    std::vector<uint64_t> remap(mph.table_size_ - mph.placed_count_, 0);
+    uint64_t free = 0;
+    for (uint64_t position = mph.placed_count_; position < mph.table_size_; ++position) {
+        if (!taken[position])
+            continue;
+        while (taken[free])
+            ++free;
+        remap[position - mph.placed_count_] = free++;
+    }
+
+    std::vector<uint64_t> words{magic, mph.key_count_, mph.placed_count_, mph.bucket_count_, mph.table_size_, mph.fallback_count_};
+    words.resize(header_words + (pilots.size() + 1) / 2, 0);
+    std::memcpy(words.data() + header_words, pilots.data(), pilots.size() * sizeof(uint32_t));
+    words.insert(words.end(), remap.begin(), remap.end());
+    for (size_t j = 0; j < equal.size(); ++j) {
+        words.push_back(hashes[equal[j]]);
+        words.push_back(mph.placed_count_ + j);
+    }
+
+    std::vector<uint64_t> slots(hashes.size());
+    for (size_t const i : unique)
+        slots[i] = positions[i] < mph.placed_count_ ? positions[i] : remap[positions[i] - mph.placed_count_];
+    for (size_t j = 0; j < equal.size(); ++j)
+        slots[equal[j]] = mph.placed_count_ + j;
+    return {std::move(words), std::move(slots)};
+}
+
+std::pair<uint64_t, uint64_t> MinimalPerfectHash::find(uint64_t hash) const noexcept {
+    if (fallback_count_ != 0) {
+        // binary search for the first fallback entry with hash
+        uint64_t first = 0;
+        uint64_t count = fallback_count_;
+        while (count > 0) {
+            uint64_t const half = count / 2;
+            if (fallback_[2 * (first + half)] < hash) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        uint64_t last = first;
+        while (last < fallback_count_ && fallback_[2 * last] == hash)
+            ++last;
+        if (first != last)
+            return {fallback_[2 * first + 1], fallback_[2 * first + 1] + (last - first)};
+    }
+
+    if (placed_count_ == 0)
+        return {0, 0};
+    uint64_t const position = position_of(hash, pilots_[bucket_of(hash)]);
+    uint64_t const slot = position < placed_count_ ? position : remap_[position - placed_count_];
+    return {slot, slot + 1};
+}
+
+uint64_t MinimalPerfectHash::bytes() const noexcept {
+    return (header_words + (bucket_count_ + 1) / 2 + (table_size_ - placed_count_) + 2 * fallback_count_) * sizeof(uint64_t);
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
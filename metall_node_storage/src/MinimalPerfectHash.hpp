@@ -0,0 +1,94 @@
+#ifndef METALL_MINIMALPERFECTHASH_HPP
+#define METALL_MINIMALPERFECTHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Minimal perfect hash over a fixed set of 64-bit key hashes, after PTHash (Pibiri and Trani, 2021).
+ * Maps each of the n hashes to a distinct slot in [0, n) at about 10 bits per key.
+ *
+ * Keys are split into buckets by their hash, 60% of them into the first 30% of the buckets. Every bucket stores a pilot,
+ * the first one that places all of its keys at free positions of a table of n / alpha positions, trying large buckets first.
+ * A key's position is reduce(mix(hash, pilot), table size). Positions past n are remapped to the free ones below n.
+ * A lookup reads one pilot, and for about 1 - alpha of the keys one remapped position.
+ * Equal hashes cannot be told apart by any pilot, they are kept in a sorted fallback table after the other slots.
+ *
+ * Hashes outside the set also get a slot, callers have to compare the key stored for it.
+ * The serialized form is a run of uint64_t words that is used in place, e.g. from a mapped file.
+ */
+class MinimalPerfectHash {
+public:
+    static constexpr double alpha = 0.97;
+    /**
+     * Buckets per key times log2 of the key count, larger values build faster and take more space.
+     */
+    static constexpr double bucket_factor = 5.0;
+
+private:
+    static constexpr uint64_t magic = 0x324648504d4c544dULL;  // "MTLMPHF2"
+    static constexpr size_t header_words = 6;
+
+    uint64_t key_count_ = 0;
+    uint64_t placed_count_ = 0;
+    uint64_t bucket_count_ = 0;
+    uint64_t table_size_ = 0;
+    uint64_t fallback_count_ = 0;
+    /**
+     * uint32_t per bucket.
+     */
+    uint32_t const *pilots_ = nullptr;
+    /**
+     * Slot of every position in [placed_count_, table_size_) that holds a key.
+     */
+    uint64_t const *remap_ = nullptr;
+    /**
+     * Pairs of (hash, slot), sorted by hash.
+     */
+    uint64_t const *fallback_ = nullptr;
+
+    [[nodiscard]] uint64_t bucket_of(uint64_t hash) const noexcept;
+    [[nodiscard]] uint64_t position_of(uint64_t hash, uint64_t pilot) const noexcept;
+
+public:
+    MinimalPerfectHash() noexcept = default;
+
+    /**
+     * Uses words written by build in place. words must outlive this object.
+     * @throws std::runtime_error if words do not hold a serialized MinimalPerfectHash
+     */
+    explicit MinimalPerfectHash(std::span<uint64_t const> words);
+
+    /**
+     * @param hashes the key hashes, equal hashes are allowed
+     * @return the serialized hash function and the slot of every hash
+     */
+    [[nodiscard]] static std::pair<std::vector<uint64_t>, std::vector<uint64_t>> build(std::span<uint64_t const> hashes);
+
+    /**
+     * @return the slots [first, last) that a key with hash may have. One slot unless hash is in the fallback table,
+     * where equal hashes share a range, and empty if no key can have hash.
+     */
+    [[nodiscard]] std::pair<uint64_t, uint64_t> find(uint64_t hash) const noexcept;
+
+    [[nodiscard]] uint64_t size() const noexcept {
+        return key_count_;
+    }
+
+    [[nodiscard]] uint64_t fallback_count() const noexcept {
+        return fallback_count_;
+    }
+
+    /**
+     * Bytes of the serialized form.
+     */
+    [[nodiscard]] uint64_t bytes() const noexcept;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_MINIMALPERFECTHASH_HPP
@@ -0,0 +1,74 @@
+#include "PrefixedStringArena.hpp"
+
+#include <array>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+using Parts = std::array<std::string_view, 2>;
+
+/**
+ * Compares the concatenations lhs[0] + lhs[1] and rhs[0] + rhs[1].
+ */
+static std::strong_ordering compare_parts(Parts lhs, Parts rhs) noexcept {
+    size_t l = 0;
+    size_t r = 0;
+    while (true) {
+        while (l < 2 && lhs[l].empty())
+            ++l;
+        while (r < 2 && rhs[r].empty())
+            ++r;
+        if (l == 2 || r == 2)
+            return (l == 2) == (r == 2) ? std::strong_ordering::equal : (l == 2 ? std::strong_ordering::less : std::strong_ordering::greater);
+
+        size_t const n = std::min(lhs[l].size(), rhs[r].size());
+        if (auto const cmp = lhs[l].substr(0, n) <=> rhs[r].substr(0, n); cmp != 0)
+            return cmp;
+        lhs[l].remove_prefix(n);
+        rhs[r].remove_prefix(n);
+    }
+}
+
+template<StoragePolicy Policy>
+PrefixedStringArena<Policy>::PrefixedStringArena(Alloc const &alloc) : suffixes_(alloc), prefixes_(alloc) {}
+
+template<StoragePolicy Policy>
+size_t PrefixedStringArena<Policy>::split(std::string_view str) noexcept {
+    size_t const separator = str.find_last_of("/#");
+    if (separator == std::string_view::npos || separator + 1 < min_prefix_length)
+        return 0;
+    return separator + 1;
+}
+
+template<StoragePolicy Policy>
+PrefixedStringRef PrefixedStringArena<Policy>::append(std::string_view str) {
+    size_t const prefix_length = split(str);
+    uint32_t const prefix_id = prefix_length == 0 ? 0 : prefixes_.find_or_add(str.substr(0, prefix_length));
+    StringRef const suffix = suffixes_.append(prefix_id == 0 ? str : str.substr(prefix_length));
+    return {.offset = suffix.offset, .length = suffix.length, .prefix_id = prefix_id};
+}
+
+template<StoragePolicy Policy>
+std::strong_ordering PrefixedStringArena<Policy>::compare(PrefixedStringRef lhs, PrefixedStringRef rhs) const noexcept {
+    return compare_parts({prefix(lhs), suffix(lhs)}, {prefix(rhs), suffix(rhs)});
+}
+
+template<StoragePolicy Policy>
+std::strong_ordering PrefixedStringArena<Policy>::compare(PrefixedStringRef ref, std::string_view str, size_t length) const noexcept {
+    Parts parts{prefix(ref), suffix(ref)};
+    parts[0] = parts[0].substr(0, length);
+    parts[1] = parts[1].substr(0, length - std::min(length, parts[0].size()));
+    return compare_parts(parts, {str, {}});
+}
+
+template<StoragePolicy Policy>
+std::string_view PrefixedStringArena<Policy>::view(PrefixedStringRef ref, std::string &buffer) const {
+    if (ref.prefix_id == 0)
+        return suffix(ref);
+    buffer.assign(prefix(ref));
+    buffer.append(suffix(ref));
+    return buffer;
+}
+
+template class PrefixedStringArena<MetallPolicy>;
+template class PrefixedStringArena<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
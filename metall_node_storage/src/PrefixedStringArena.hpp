@@ -0,0 +1,139 @@
+#ifndef METALL_PREFIXEDSTRINGARENA_HPP
+#define METALL_PREFIXEDSTRINGARENA_HPP
+
+#include "StoragePolicy.hpp"
+#include "StringArena.hpp"
+#include "StringDictionary.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Position of a string in a PrefixedStringArena: a shared prefix and the suffix that follows it.
+ * prefix_id 0 means that the whole string is stored as the suffix.
+ */
+struct PrefixedStringRef {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+    uint32_t prefix_id = 0;
+
+    [[nodiscard]] bool null() const noexcept {
+        return offset == 0;
+    }
+
+    [[nodiscard]] StringRef suffix() const noexcept {
+        return {.offset = offset, .length = length};
+    }
+};
+
+/**
+ * StringArena for IRIs that stores every distinct namespace prefix only once.
+ * A string is split after its last '/' or '#'. The part up to there goes into a prefix dictionary,
+ * only the rest is appended to the arena. Short prefixes are not worth an entry and are kept inline.
+ *
+ * The prefixes are kept in a lock-free StringDictionary. Like StringArena, append is thread-safe and readers need no lock.
+ * Once the dictionary is full, new prefixes are stored inline.
+ */
+template<StoragePolicy Policy>
+class PrefixedStringArena {
+public:
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+    static constexpr size_t max_prefixes = StringDictionary<Policy>::max_entries;
+    static constexpr size_t min_prefix_length = 8;
+
+private:
+    StringArena<Policy> suffixes_;
+    StringDictionary<Policy> prefixes_;
+
+public:
+    explicit PrefixedStringArena(Alloc const &alloc);
+
+    PrefixedStringArena(PrefixedStringArena const &) = delete;
+    PrefixedStringArena &operator=(PrefixedStringArena const &) = delete;
+
+    /**
+     * @return length of the prefix that str is split at, 0 if str is stored as a whole
+     */
+    [[nodiscard]] static size_t split(std::string_view str) noexcept;
+
+    /**
+     * Copies str into the arena, sharing its prefix with earlier strings.
+     * @throws std::length_error if the arena is full
+     */
+    PrefixedStringRef append(std::string_view str);
+
+    [[nodiscard]] std::string_view prefix(PrefixedStringRef ref) const noexcept {
+        return prefixes_.view(ref.prefix_id);
+    }
+
+    [[nodiscard]] std::string_view suffix(PrefixedStringRef ref) const noexcept {
+        return suffixes_.view(ref.suffix());
+    }
+
+    /**
+     * Compares without rebuilding the string.
+     */
+    [[nodiscard]] bool equals(PrefixedStringRef ref, std::string_view str) const noexcept {
+        std::string_view const pre = prefix(ref);
+        return str.size() == pre.size() + ref.length && str.starts_with(pre) && str.substr(pre.size()) == suffix(ref);
+    }
+
+    /**
+     * Lexicographic order of the whole strings, without rebuilding them.
+     */
+    [[nodiscard]] std::strong_ordering compare(PrefixedStringRef lhs, PrefixedStringRef rhs) const noexcept;
+
+    /**
+     * Like compare, but only the first length bytes of the string in ref take part.
+     */
+    [[nodiscard]] std::strong_ordering compare(PrefixedStringRef ref, std::string_view str,
+                                               size_t length = std::string_view::npos) const noexcept;
+
+    /**
+     * The whole string. If it is split, it is rebuilt into buffer and the view points there.
+     */
+    [[nodiscard]] std::string_view view(PrefixedStringRef ref, std::string &buffer) const;
+
+    [[nodiscard]] uint32_t prefix_count() const noexcept {
+        return prefixes_.size();
+    }
+
+    /**
+     * See StringArena::for_each_chunk. Visits the prefixes first, they are shared by many strings.
+     */
+    template<typename F>
+    void for_each_chunk(F &&f) const {
+        prefixes_.for_each_chunk(f);
+        suffixes_.for_each_chunk(f);
+    }
+
+    [[nodiscard]] uint64_t bytes_used() const noexcept {
+        return suffixes_.bytes_used() + prefixes_.bytes_used();
+    }
+
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return suffixes_.bytes_reserved() + prefixes_.bytes_reserved();
+    }
+
+    [[nodiscard]] uint64_t string_bytes() const noexcept {
+        return suffixes_.string_bytes() + prefixes_.string_bytes();
+    }
+
+    /**
+     * Number of appended strings, the prefixes are not counted.
+     */
+    [[nodiscard]] uint64_t string_count() const noexcept {
+        return suffixes_.string_count();
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_PREFIXEDSTRINGARENA_HPP
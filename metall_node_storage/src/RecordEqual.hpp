@@ -0,0 +1,52 @@
+#ifndef METALL_RECORDEQUAL_HPP
+#define METALL_RECORDEQUAL_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+#include <rdf4cpp/rdf/storage/node/view/LiteralBackendView.hpp>
+
+#include "LiteralBackend.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Equality of stored records and one backend view, for any node type.
+ * The record is compared in place with the view, without building a backend object or a view from it.
+ * Callers only pass candidates whose hash already matched in a HashIndex slot or a FrontCache entry,
+ * so the hash stored next to the record (see DenseIDTable) is not compared again.
+ * For literals the language tag of the view is looked up once on construction, candidates compare tag ids.
+ */
+template<typename Storage_t, typename Arena_t, typename View_t>
+class RecordEqual {
+    static constexpr bool literal = std::is_same_v<View_t, view::LiteralBackendView>;
+
+    Storage_t const &storage_;
+    Arena_t const &arena_;
+    View_t const &view_;
+    /**
+     * LiteralBackend::language_tag_key of the view, unused for other node types.
+     */
+    uint32_t language_tag_key_ = 0;
+
+public:
+    RecordEqual(Storage_t const &storage, Arena_t const &arena, View_t const &view) noexcept
+        : storage_(storage), arena_(arena), view_(view) {
+        if constexpr (literal)
+            language_tag_key_ = LiteralBackend::language_tag_key(arena, view.language_tag);
+    }
+
+    [[nodiscard]] bool operator()(identifier::NodeID id) const noexcept {
+        if constexpr (literal)
+            return storage_[id].equals(arena_, view_, language_tag_key_);
+        else
+            return storage_[id].equals(arena_, view_);
+    }
+};
+
+template<typename Storage_t, typename Arena_t, typename View_t>
+RecordEqual(Storage_t const &, Arena_t const &, View_t const &) -> RecordEqual<Storage_t, Arena_t, View_t>;
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_RECORDEQUAL_HPP
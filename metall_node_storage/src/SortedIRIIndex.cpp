@@ -0,0 +1,55 @@
+#include "SortedIRIIndex.hpp"
+
+#include <algorithm>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+template<StoragePolicy Policy>
+SortedIRIIndex<Policy>::SortedIRIIndex(Storage const &storage, Arena const &arena, DecodedStrings &decoded)
+    : storage_(&storage), arena_(&arena), decoded_(&decoded), storage_inserted_(storage.insert_count()), storage_erased_(storage.erased_count()) {
+    ids_.reserve(storage.size());
+    storage.for_each([&](NodeID id, IRIBackend const &) {
+        ids_.push_back(id);
+    });
+    std::ranges::sort(ids_, [&](NodeID lhs, NodeID rhs) {
+        return storage[lhs].compare(arena, storage[rhs]) < 0;
+    });
+}
+
+template<StoragePolicy Policy>
+std::string_view SortedIRIIndex<Policy>::identifier(NodeID id) const {
+    IRIBackend const &record = (*storage_)[id];
+    if (record.contiguous()) {
+        std::string unused;
+        return record.identifier(*arena_, unused);
+    }
+    return decoded_->find_or_decode(id.value(), [&](std::string &buffer) {
+        return record.identifier(*arena_, buffer);
+    });
+}
+
+template<StoragePolicy Policy>
+typename SortedIRIIndex<Policy>::Range SortedIRIIndex<Policy>::range(std::string_view first, std::string_view last) const {
+    auto const begin = std::ranges::partition_point(ids_, [&](NodeID id) {
+        return (*storage_)[id].compare(*arena_, first) < 0;
+    });
+    auto const end = last.empty() ? ids_.end() : std::partition_point(begin, ids_.end(), [&](NodeID id) {
+        return (*storage_)[id].compare(*arena_, last) < 0;
+    });
+    return {at(begin), at(end)};
+}
+
+template<StoragePolicy Policy>
+typename SortedIRIIndex<Policy>::Range SortedIRIIndex<Policy>::with_prefix(std::string_view prefix) const {
+    auto const begin = std::ranges::partition_point(ids_, [&](NodeID id) {
+        return (*storage_)[id].compare(*arena_, prefix) < 0;
+    });
+    auto const end = std::partition_point(begin, ids_.end(), [&](NodeID id) {
+        return (*storage_)[id].compare(*arena_, prefix, prefix.size()) == 0;
+    });
+    return {at(begin), at(end)};
+}
+
+template class SortedIRIIndex<MetallPolicy>;
+template class SortedIRIIndex<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef METALL_SORTEDIRIINDEX_HPP
+#define METALL_SORTEDIRIINDEX_HPP
+
+#include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
+
+#include "DecodedStrings.hpp"
+#include "DenseIDTable.hpp"
+#include "IRIBackend.hpp"
+#include "PrefixedStringArena.hpp"
+#include "StoragePolicy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Process-local sorted run of the IRIs of a BasicNodeStore, for prefix and lexicographic range scans.
+ * It is a snapshot: IRIs added after construction are not visited and erased IRIs are still visited.
+ * MetallNodeStorageBackend::sorted_iris rebuilds it when the store has changed.
+ * The IRIs are read from the store while scanning, the index itself holds only the NodeIDs in IRI order.
+ * IRIs stored with a prefix are rebuilt into the DecodedStrings of the backend, the same copy find_iri_backend_view returns.
+ */
+template<StoragePolicy Policy>
+class SortedIRIIndex {
+public:
+    using NodeID = identifier::NodeID;
+    using Storage = DenseIDTable<Policy, IRIBackend>;
+    using Arena = PrefixedStringArena<Policy>;
+
+    /**
+     * Forward iterator over (NodeID, IRI) pairs in lexicographic order of the IRIs.
+     * The views have the lifetime of find_iri_backend_view: IRIs stored without a prefix are viewed in the mapping,
+     * the others in the DecodedStrings, which lives as long as the backend.
+     */
+    class Iterator {
+        SortedIRIIndex const *index_ = nullptr;
+        std::vector<NodeID>::const_iterator pos_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<NodeID, std::string_view>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        Iterator() noexcept = default;
+        Iterator(SortedIRIIndex const *index, std::vector<NodeID>::const_iterator pos) noexcept : index_(index), pos_(pos) {}
+
+        [[nodiscard]] value_type operator*() const {
+            return {*pos_, index_->identifier(*pos_)};
+        }
+
+        Iterator &operator++() noexcept {
+            ++pos_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++pos_;
+            return old;
+        }
+
+        [[nodiscard]] bool operator==(Iterator const &other) const noexcept {
+            return pos_ == other.pos_;
+        }
+    };
+
+    struct Range {
+        Iterator first;
+        Iterator last;
+
+        [[nodiscard]] Iterator begin() const noexcept {
+            return first;
+        }
+
+        [[nodiscard]] Iterator end() const noexcept {
+            return last;
+        }
+    };
+
+private:
+    Storage const *storage_;
+    Arena const *arena_;
+    DecodedStrings *decoded_;
+    std::vector<NodeID> ids_;
+    /**
+     * storage.insert_count() and storage.erased_count() when the index was built.
+     */
+    uint64_t storage_inserted_;
+    uint64_t storage_erased_;
+
+    [[nodiscard]] std::string_view identifier(NodeID id) const;
+
+    [[nodiscard]] Iterator at(std::vector<NodeID>::const_iterator pos) const noexcept {
+        return {this, pos};
+    }
+
+public:
+    /**
+     * Sorts all live IRIs of storage. Writers must be paused, see DenseIDTable::for_each.
+     * @param decoded where IRIs stored with a prefix are rebuilt, keyed by NodeID
+     */
+    SortedIRIIndex(Storage const &storage, Arena const &arena, DecodedStrings &decoded);
+
+    /**
+     * @return true if IRIs were added to or erased from the storage since the index was built
+     */
+    [[nodiscard]] bool stale() const noexcept {
+        return storage_inserted_ != storage_->insert_count() || storage_erased_ != storage_->erased_count();
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return ids_.size();
+    }
+
+    [[nodiscard]] Range all() const noexcept {
+        return {at(ids_.begin()), at(ids_.end())};
+    }
+
+    /**
+     * IRIs in [first, last). An empty last means no upper bound.
+     */
+    [[nodiscard]] Range range(std::string_view first, std::string_view last = {}) const;
+
+    /**
+     * IRIs that start with prefix.
+     */
+    [[nodiscard]] Range with_prefix(std::string_view prefix) const;
+};
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_SORTEDIRIINDEX_HPP
@@ -0,0 +1,146 @@
+#ifndef METALL_STORAGEPOLICY_HPP
+#define METALL_STORAGEPOLICY_HPP
+
+#include <metall/metall.hpp>
+#include <metall/container/vector.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Where the containers of a node store allocate their memory and how they point into it.
+ * Chosen at compile time, every persistent container is a template over it.
+ */
+template<typename Policy>
+concept StoragePolicy = requires {
+    typename Policy::manager_type;
+    typename Policy::template allocator_type<std::byte>;
+    typename Policy::template pointer<char>;
+    typename Policy::template vector<int>;
+};
+
+/**
+ * Process-local stand-in for the parts of metall::manager that a node store uses.
+ * Named objects are heap-allocated and destroyed with the manager. Nothing is persisted: flush does nothing
+ * and snapshot fails.
+ */
+class HeapManager {
+    struct NamedObject {
+        void *object;
+        void (*destroy)(void *) noexcept;
+    };
+
+    std::unordered_map<std::string, NamedObject> objects_;
+
+public:
+    template<typename T>
+    using allocator_type = std::allocator<T>;
+
+    HeapManager() = default;
+    HeapManager(HeapManager const &) = delete;
+    HeapManager &operator=(HeapManager const &) = delete;
+
+    ~HeapManager() {
+        for (auto const &[name, named] : objects_)
+            named.destroy(named.object);
+    }
+
+    /**
+     * @return the object named name and its count (always 1), or nullptr and 0
+     */
+    template<typename T>
+    [[nodiscard]] std::pair<T *, size_t> find(char const *name) const {
+        auto const it = objects_.find(name);
+        if (it == objects_.end())
+            return {nullptr, 0};
+        return {static_cast<T *>(it->second.object), 1};
+    }
+
+    /**
+     * Same call syntax as Metall: <code>manager.find_or_construct<T>(name)(args...)</code>.
+     */
+    template<typename T>
+    [[nodiscard]] auto find_or_construct(char const *name) {
+        return [this, name]<typename... Args>(Args &&...args) -> T * {
+            if (T *const found = find<T>(name).first; found != nullptr)
+                return found;
+            T *const object = new T(std::forward<Args>(args)...);
+            objects_.emplace(name, NamedObject{.object = object, .destroy = [](void *p) noexcept { delete static_cast<T *>(p); }});
+            return object;
+        };
+    }
+
+    template<typename T = std::byte>
+    [[nodiscard]] allocator_type<T> get_allocator() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]] bool read_only() const noexcept {
+        return false;
+    }
+
+    bool flush() const noexcept {
+        return true;
+    }
+
+    bool snapshot([[maybe_unused]] char const *destination_path) const noexcept {
+        return false;
+    }
+
+    /**
+     * There is no single mapping, the objects are spread over the heap.
+     */
+    [[nodiscard]] void *get_address() const noexcept {
+        return nullptr;
+    }
+
+    [[nodiscard]] size_t get_size() const noexcept {
+        return 0;
+    }
+};
+
+/**
+ * Persistent storage in a Metall datastore. Pointers are offset_ptrs, so the datastore can be mapped at any address.
+ */
+struct MetallPolicy {
+    using manager_type = metall::manager;
+
+    template<typename T>
+    using allocator_type = metall::manager::allocator_type<T>;
+
+    template<typename T>
+    using pointer = metall::offset_ptr<T>;
+
+    template<typename T>
+    using vector = metall::container::vector<T, allocator_type<T>>;
+};
+
+/**
+ * Process-local storage on the heap, for tests and ephemeral caches. Pointers are plain pointers,
+ * which saves the offset arithmetic of offset_ptr on every access.
+ */
+struct HeapPolicy {
+    using manager_type = HeapManager;
+
+    template<typename T>
+    using allocator_type = std::allocator<T>;
+
+    template<typename T>
+    using pointer = T *;
+
+    template<typename T>
+    using vector = std::vector<T, allocator_type<T>>;
+};
+
+static_assert(StoragePolicy<MetallPolicy>);
+static_assert(StoragePolicy<HeapPolicy>);
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_STORAGEPOLICY_HPP
@@ -0,0 +1,64 @@
+#ifndef METALL_STORAGESTATS_HPP
+#define METALL_STORAGESTATS_HPP
+
+#include <cstdint>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Occupancy of the storage of one node type.
+ * Taken without pausing writers, so the numbers of a busy store may be slightly inconsistent with each other.
+ */
+struct NodeTypeStats {
+    /**
+     * Stored nodes that were not erased. Inlined literals are not stored and not counted.
+     */
+    uint64_t count = 0;
+    uint64_t erased = 0;
+
+    /**
+     * Bytes of all stored strings, including the ones of erased nodes until the store is compacted.
+     */
+    uint64_t string_bytes = 0;
+    double average_string_length = 0;
+
+    /**
+     * Reverse index: bytes of all hash slots, and the fill of the whole index and of its fullest stripe.
+     */
+    uint64_t index_bytes = 0;
+    double index_load_factor = 0;
+    double max_stripe_load_factor = 0;
+
+    /**
+     * Stripe lock acquisitions that had to wait, since this backend was attached.
+     */
+    uint64_t lock_contentions = 0;
+
+    uint64_t forward_bytes_reserved = 0;
+    uint64_t forward_bytes_used = 0;
+    uint64_t arena_bytes_reserved = 0;
+    uint64_t arena_bytes_used = 0;
+    /**
+     * Process-local copies of the viewed nodes that have no contiguous record, see DecodedStrings.
+     */
+    uint64_t decoded_bytes_reserved = 0;
+};
+
+struct StorageStats {
+    NodeTypeStats literal;
+    NodeTypeStats bnode;
+    NodeTypeStats iri;
+    NodeTypeStats variable;
+
+    /**
+     * Distinct namespace prefixes that IRIs share, see PrefixedStringArena.
+     */
+    uint64_t iri_prefixes = 0;
+    /**
+     * Distinct language tags of the stored literals.
+     */
+    uint64_t language_tags = 0;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_STORAGESTATS_HPP
@@ -0,0 +1,132 @@
+#include "StringArena.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+template<StoragePolicy Policy>
+StringArena<Policy>::StringArena(Alloc const &alloc) : alloc_(alloc) {}
+
+template<StoragePolicy Policy>
+StringArena<Policy>::~StringArena() {
+    typename Policy::template allocator_type<char> char_alloc = alloc_;
+    size_t const count = std::min(chunk_count_.load(), max_chunks);
+    for (size_t i = 1; i < count; ++i) {
+        char *const c = chunk(i);
+        // dedicated chunks hold exactly one record, its length prefix tells the chunk size
+        length_prefix_t first_length;
+        std::memcpy(&first_length, c, sizeof(first_length));
+        char_alloc.deallocate(typename std::allocator_traits<decltype(char_alloc)>::pointer(c),
+                              std::max<uint64_t>(chunk_size, sizeof(length_prefix_t) + first_length));
+    }
+
+    PageAlloc page_alloc = alloc_;
+    for (size_t i = 0; i < pages_.size(); ++i) {
+        if (DirectoryPage *const p = page(i); p != nullptr) {
+            p->~DirectoryPage();
+            page_alloc.deallocate(typename std::allocator_traits<PageAlloc>::pointer(p), 1);
+        }
+    }
+}
+
+template<StoragePolicy Policy>
+typename StringArena<Policy>::DirectoryPage &StringArena<Policy>::ensure_page(size_t i) {
+    if (DirectoryPage *const p = page(i); p != nullptr)
+        return *p;
+
+    PageAlloc page_alloc = alloc_;
+    auto const fresh = page_alloc.allocate(1);
+    DirectoryPage *const raw = ::new (static_cast<void *>(&*fresh)) DirectoryPage();
+
+    std::ptrdiff_t expected = 0;
+    std::ptrdiff_t const relative = reinterpret_cast<char *>(raw) - reinterpret_cast<char *>(this);
+    if (pages_[i].compare_exchange_strong(expected, relative, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        bytes_reserved_ += sizeof(DirectoryPage);
+        return *raw;
+    }
+
+    // another add_chunk published the page first
+    raw->~DirectoryPage();
+    page_alloc.deallocate(fresh, 1);
+    return *page(i);
+}
+
+template<StoragePolicy Policy>
+size_t StringArena<Policy>::add_chunk(uint64_t capacity) {
+    size_t const index = chunk_count_.fetch_add(1);
+    if (index >= max_chunks) {
+        chunk_count_ = max_chunks;
+        throw std::length_error("StringArena is full.");
+    }
+
+    DirectoryPage &p = ensure_page(index / chunks_per_page);
+    typename Policy::template allocator_type<char> char_alloc = alloc_;
+    p.chunks[index % chunks_per_page] = char_alloc.allocate(capacity);
+    bytes_reserved_ += capacity;
+    return index;
+}
+
+template<StoragePolicy Policy>
+StringRef StringArena<Policy>::append(std::string_view str) {
+    if (str.size() > std::numeric_limits<length_prefix_t>::max())
+        throw std::length_error("String is too long to be stored in a StringArena.");
+
+    uint64_t const record_size = sizeof(length_prefix_t) + str.size();
+    // keep the length prefixes aligned
+    uint64_t const aligned_size = (record_size + alignof(length_prefix_t) - 1) & ~uint64_t{alignof(length_prefix_t) - 1};
+    uint64_t chunk;
+    uint64_t pos;
+    if (record_size > chunk_size) {
+        chunk = add_chunk(record_size);
+        pos = 0;
+    } else {
+        for (;;) {
+            uint64_t const open = open_.fetch_add(aligned_size, std::memory_order_acq_rel);
+            chunk = open >> open_pos_bits;
+            pos = open & ((uint64_t{1} << open_pos_bits) - 1);
+            if (chunk != 0 && pos + aligned_size <= chunk_size)
+                break;
+
+            if (pos <= chunk_size) {
+                // this append crossed the end of the open chunk, it opens the next one and claims its start
+                chunk = add_chunk(chunk_size);
+                pos = 0;
+                open_.store((chunk << open_pos_bits) | aligned_size, std::memory_order_release);
+                break;
+            }
+            // another append is opening the next chunk
+            while (open_.load(std::memory_order_acquire) >> open_pos_bits == chunk) {
+                if (chunk_count_.load() >= max_chunks)
+                    throw std::length_error("StringArena is full.");
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    char *record = this->chunk(chunk) + pos;
+    auto const length = static_cast<length_prefix_t>(str.size());
+    std::memcpy(record, &length, sizeof(length));
+    std::memcpy(record + sizeof(length), str.data(), str.size());
+    bytes_used_ += record_size;
+    string_count_.fetch_add(1, std::memory_order_relaxed);
+
+    return {.offset = (chunk << chunk_bits) | pos, .length = length};
+}
+
+template<StoragePolicy Policy>
+std::string_view StringArena<Policy>::view(uint64_t offset) const noexcept {
+    char const *record = address(offset);
+    length_prefix_t length;
+    std::memcpy(&length, record, sizeof(length));
+    return {record + sizeof(length), length};
+}
+
+template class StringArena<MetallPolicy>;
+template class StringArena<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
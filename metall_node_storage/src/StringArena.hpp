@@ -0,0 +1,173 @@
+#ifndef METALL_STRINGARENA_HPP
+#define METALL_STRINGARENA_HPP
+
+#include "StoragePolicy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Position of a string in a StringArena.
+ * The offset is relative to the arena and not an address, so it stays valid when the datastore is mapped somewhere else.
+ */
+struct StringRef {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+
+    [[nodiscard]] bool null() const noexcept {
+        return offset == 0;
+    }
+};
+
+/**
+ * Append-only string storage inside the datastore of Policy.
+ * Records are length-prefixed and packed into fixed-size chunks. Strings larger than a chunk get a chunk of their own.
+ * Chunks are never moved or freed, so views into the arena stay valid for as long as the datastore is mapped.
+ * append is thread-safe: space in the open chunk is claimed with an atomic bump, only switching chunks waits.
+ * A record may be read by other threads once its StringRef was published to them, e.g. through a lock.
+ */
+template<StoragePolicy Policy>
+class StringArena {
+public:
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+    using length_prefix_t = uint32_t;
+
+    static constexpr unsigned chunk_bits = 22;
+    static constexpr uint64_t chunk_size = uint64_t{1} << chunk_bits;
+    static constexpr size_t max_chunks = size_t{1} << 16;
+    static constexpr size_t chunks_per_page = size_t{1} << 8;
+
+private:
+    /**
+     * Chunk pointers are kept in pages that are allocated with the first chunk they hold, so an empty arena stays small.
+     */
+    struct DirectoryPage {
+        std::array<typename Policy::template pointer<char>, chunks_per_page> chunks{};
+    };
+
+    using PageAlloc = typename Policy::template allocator_type<DirectoryPage>;
+
+    Alloc alloc_;
+    /**
+     * Page addresses relative to this object, 0 for pages that are not allocated yet. See DenseIDTable::segments_.
+     * Chunk slot 0 is never used, so that no record is at offset 0.
+     */
+    std::array<std::atomic<std::ptrdiff_t>, max_chunks / chunks_per_page> pages_{};
+    std::atomic<size_t> chunk_count_ = 1;
+    /**
+     * Chunk that small records are currently appended to (upper bits) and the append position in it (lower open_pos_bits).
+     * Concurrent appends may push the position past chunk_size. The one append that crosses the end opens the next chunk.
+     * Starts with no open chunk (index 0) and a full position, so the first append opens one.
+     */
+    std::atomic<uint64_t> open_ = chunk_size;
+    std::atomic<uint64_t> bytes_used_ = 0;
+    std::atomic<uint64_t> bytes_reserved_ = 0;
+    std::atomic<uint64_t> string_count_ = 0;
+
+    static constexpr unsigned open_pos_bits = 40;
+
+    [[nodiscard]] static uint64_t chunk_index(uint64_t offset) noexcept {
+        return offset >> chunk_bits;
+    }
+
+    [[nodiscard]] static uint64_t chunk_offset(uint64_t offset) noexcept {
+        return offset & (chunk_size - 1);
+    }
+
+    [[nodiscard]] DirectoryPage *page(size_t i) const noexcept {
+        std::ptrdiff_t const relative = pages_[i].load(std::memory_order_acquire);
+        if (relative == 0)
+            return nullptr;
+        return reinterpret_cast<DirectoryPage *>(reinterpret_cast<char *>(const_cast<StringArena *>(this)) + relative);
+    }
+
+    /**
+     * @return the chunk with the given index, or nullptr if it is not allocated yet
+     */
+    [[nodiscard]] char *chunk(size_t index) const noexcept {
+        DirectoryPage const *const p = page(index / chunks_per_page);
+        return p == nullptr ? nullptr : std::to_address(p->chunks[index % chunks_per_page]);
+    }
+
+    [[nodiscard]] char const *address(uint64_t offset) const noexcept {
+        return chunk(chunk_index(offset)) + chunk_offset(offset);
+    }
+
+    DirectoryPage &ensure_page(size_t i);
+
+    /**
+     * @return index of the new chunk
+     */
+    size_t add_chunk(uint64_t capacity);
+
+public:
+    explicit StringArena(Alloc const &alloc);
+    ~StringArena();
+
+    StringArena(StringArena const &) = delete;
+    StringArena &operator=(StringArena const &) = delete;
+
+    /**
+     * Copies str into the arena.
+     * @throws std::length_error if str does not fit into the length prefix or the arena is full
+     */
+    StringRef append(std::string_view str);
+
+    /**
+     * An empty StringRef is allowed and yields an empty view.
+     */
+    [[nodiscard]] std::string_view view(StringRef ref) const noexcept {
+        if (ref.length == 0)
+            return {};
+        return {address(ref.offset) + sizeof(length_prefix_t), ref.length};
+    }
+
+    /**
+     * Reads a record only from its offset, using the stored length prefix.
+     */
+    [[nodiscard]] std::string_view view(uint64_t offset) const noexcept;
+
+    /**
+     * Calls f(char const *address, size_t bytes) for every chunk. Of chunks dedicated to a single large string
+     * only the first chunk_size bytes are passed. Chunks opened concurrently may or may not be visited.
+     */
+    template<typename F>
+    void for_each_chunk(F &&f) const {
+        size_t const count = std::min(chunk_count_.load(std::memory_order_acquire), max_chunks);
+        for (size_t i = 1; i < count; ++i) {
+            if (char const *const c = chunk(i); c != nullptr)
+                f(c, chunk_size);
+        }
+    }
+
+    /**
+     * Bytes of all records, including their length prefixes.
+     */
+    [[nodiscard]] uint64_t bytes_used() const noexcept {
+        return bytes_used_;
+    }
+
+    /**
+     * Bytes of the strings themselves, without length prefixes.
+     */
+    [[nodiscard]] uint64_t string_bytes() const noexcept {
+        return bytes_used_ - string_count_ * sizeof(length_prefix_t);
+    }
+
+    [[nodiscard]] uint64_t string_count() const noexcept {
+        return string_count_;
+    }
+
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return bytes_reserved_;
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_STRINGARENA_HPP
@@ -0,0 +1,47 @@
+#include "StringDictionary.hpp"
+
+#include "ViewHash.hpp"
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+template<StoragePolicy Policy>
+StringDictionary<Policy>::StringDictionary(Alloc const &alloc) : strings_(alloc) {}
+
+template<StoragePolicy Policy>
+uint32_t StringDictionary<Policy>::find_or_add(std::string_view str) {
+    uint64_t const hash = ViewHash::hash_bytes(str);
+    uint32_t reserved = 0;
+    for (size_t pos = hash & (slot_count - 1);; pos = (pos + 1) & (slot_count - 1)) {
+        uint32_t id = slots_[pos].load(std::memory_order_acquire);
+        if (id == 0) {
+            if (reserved == 0) {
+                if (next_id_.load(std::memory_order_relaxed) >= max_entries)
+                    return 0;
+                reserved = next_id_.fetch_add(1, std::memory_order_relaxed);
+                if (reserved >= max_entries)
+                    return 0;
+                entries_[reserved] = strings_.append(str);
+            }
+            if (slots_[pos].compare_exchange_strong(id, reserved, std::memory_order_acq_rel, std::memory_order_acquire))
+                return reserved;
+            // another string was published into this slot in the meantime, id holds it now
+        }
+        // if this is a concurrently added copy of str, the reserved id stays unused
+        if (strings_.view(entries_[id]) == str)
+            return id;
+    }
+}
+
+template<StoragePolicy Policy>
+uint32_t StringDictionary<Policy>::find(std::string_view str) const noexcept {
+    uint64_t const hash = ViewHash::hash_bytes(str);
+    for (size_t pos = hash & (slot_count - 1);; pos = (pos + 1) & (slot_count - 1)) {
+        uint32_t const id = slots_[pos].load(std::memory_order_acquire);
+        if (id == 0 || strings_.view(entries_[id]) == str)
+            return id;
+    }
+}
+
+template class StringDictionary<MetallPolicy>;
+template class StringDictionary<HeapPolicy>;
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
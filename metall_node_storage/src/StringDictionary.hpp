@@ -0,0 +1,92 @@
+#ifndef METALL_STRINGDICTIONARY_HPP
+#define METALL_STRINGDICTIONARY_HPP
+
+#include "StoragePolicy.hpp"
+#include "StringArena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Persistent set of up to 2^16 - 1 distinct strings, each identified by a small id that is never reused.
+ * Used for strings that many records share, like IRI namespace prefixes and language tags.
+ *
+ * Lock-free: ids are reserved with an atomic counter and published into an open-addressing table with a compare-exchange.
+ * Concurrent adds of the same string agree on one id, the ids reserved by the losers stay unused.
+ */
+template<StoragePolicy Policy>
+class StringDictionary {
+public:
+    using Alloc = typename Policy::template allocator_type<std::byte>;
+
+    static constexpr size_t max_entries = size_t{1} << 16;
+
+private:
+    static constexpr size_t slot_count = max_entries * 2;
+
+    StringArena<Policy> strings_;
+    /**
+     * Indexed by id, entry 0 is unused.
+     */
+    std::array<StringRef, max_entries> entries_{};
+    /**
+     * Open-addressing table string hash -> id, 0 marks an empty slot.
+     */
+    std::array<std::atomic<uint32_t>, slot_count> slots_{};
+    std::atomic<uint32_t> next_id_ = 1;
+
+public:
+    explicit StringDictionary(Alloc const &alloc);
+
+    StringDictionary(StringDictionary const &) = delete;
+    StringDictionary &operator=(StringDictionary const &) = delete;
+
+    /**
+     * @return id of str, adding it if necessary, or 0 if the dictionary is full
+     */
+    uint32_t find_or_add(std::string_view str);
+
+    /**
+     * @return id of str, or 0 if it was not added
+     */
+    [[nodiscard]] uint32_t find(std::string_view str) const noexcept;
+
+    /**
+     * id 0 yields an empty view.
+     */
+    [[nodiscard]] std::string_view view(uint32_t id) const noexcept {
+        return strings_.view(entries_[id]);
+    }
+
+    [[nodiscard]] uint32_t size() const noexcept {
+        return std::min<uint32_t>(next_id_.load(std::memory_order_relaxed), max_entries) - 1;
+    }
+
+    /**
+     * See StringArena::for_each_chunk.
+     */
+    template<typename F>
+    void for_each_chunk(F &&f) const {
+        strings_.for_each_chunk(f);
+    }
+
+    [[nodiscard]] uint64_t bytes_used() const noexcept {
+        return strings_.bytes_used();
+    }
+
+    [[nodiscard]] uint64_t bytes_reserved() const noexcept {
+        return strings_.bytes_reserved();
+    }
+
+    [[nodiscard]] uint64_t string_bytes() const noexcept {
+        return strings_.string_bytes();
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_STRINGDICTIONARY_HPP
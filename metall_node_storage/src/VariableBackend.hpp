@@ -1,44 +1,61 @@
 #ifndef METALL_VARIABLEBACKEND_HPP
 #define METALL_VARIABLEBACKEND_HPP
 
-#include <metall/metall.hpp>
-
 #include <rdf4cpp/rdf/storage/node/identifier/NodeID.hpp>
 #include <rdf4cpp/rdf/storage/node/view/VariableBackendView.hpp>
 
+#include "StringArena.hpp"
+
 #include <compare>
-#include <memory>
 #include <string>
 #include <string_view>
 
 namespace rdf4cpp::rdf::storage::node::metall_node_storage {
 
+/**
+ * Stored variable. The name lives in a StringArena, the record only keeps its position.
+ */
 class VariableBackend {
-    std::string name_;
-    bool anonymous_;
+    StringRef name_;
+    bool anonymous_ = false;
 
 public:
-    explicit VariableBackend(std::string_view name, bool anonymous = false) noexcept;
-    explicit VariableBackend(view::VariableBackendView view) noexcept;
-    auto operator<=>(const VariableBackend &) const noexcept = default;
-    auto operator<=>(view::VariableBackendView const &other) const noexcept {
-        return view::VariableBackendView(*this) <=> other;
+    VariableBackend() noexcept = default;
+    template<StoragePolicy Policy>
+    VariableBackend(StringArena<Policy> &arena, std::string_view name, bool anonymous = false)
+        : name_(arena.append(name)), anonymous_(anonymous) {}
+    template<StoragePolicy Policy>
+    VariableBackend(StringArena<Policy> &arena, view::VariableBackendView view) : name_(arena.append(view.name)), anonymous_(view.is_anonymous) {}
+
+    [[nodiscard]] bool null() const noexcept {
+        return name_.null();
     }
-    std::partial_ordering operator<=>(metall::offset_ptr<VariableBackend> const &other) const noexcept;
 
     [[nodiscard]] bool is_anonymous() const noexcept;
 
-    [[nodiscard]] std::string_view name() const noexcept;
+    template<StoragePolicy Policy>
+    [[nodiscard]] std::string_view name(StringArena<Policy> const &arena) const noexcept {
+        return arena.view(name_);
+    }
 
-    explicit operator view::VariableBackendView() const noexcept;
-};
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::VariableBackendView view(StringArena<Policy> const &arena) const noexcept {
+        return {.name = name(arena),
+                .is_anonymous = is_anonymous()};
+    }
 
-std::partial_ordering operator<=>(metall::offset_ptr<VariableBackend> const &self, metall::offset_ptr<VariableBackend> const &other) noexcept;
-}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+    /**
+     * The record is contiguous in the arena, buffer is not used. Same interface as IRIBackend.
+     */
+    template<StoragePolicy Policy>
+    [[nodiscard]] view::VariableBackendView view(StringArena<Policy> const &arena, [[maybe_unused]] std::string &buffer) const noexcept {
+        return view(arena);
+    }
 
-namespace rdf4cpp::rdf::storage::node::view {
-inline std::partial_ordering operator<=>(VariableBackendView const &lhs, metall::offset_ptr<metall_node_storage::VariableBackend> const &rhs) noexcept {
-    return lhs <=> VariableBackendView(*rhs);
-}
-}  // namespace rdf4cpp::rdf::storage::node::view
+    template<StoragePolicy Policy>
+    [[nodiscard]] bool equals(StringArena<Policy> const &arena, view::VariableBackendView const &view) const noexcept {
+        return std::is_eq(this->view(arena) <=> view);
+    }
+};
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
 #endif  //METALL_VARIABLEBACKEND_HPP
@@ -0,0 +1,69 @@
+#ifndef METALL_VIEWCHECKER_HPP
+#define METALL_VIEWCHECKER_HPP
+
+#include "ViewHash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Debug helper that checks the view lifetime contract of MetallNodeStorageBackend, see ViewLifetime.
+ * It remembers the bytes of every string handed out and verifies that they were neither moved nor overwritten since.
+ * Every view is recorded, so a view into a buffer that is reused, e.g. one of the calling thread, fails the check.
+ * Views that must point into the mapped datastore are checked to actually do so, unless the datastore has no single mapping (HeapPolicy).
+ * Only used if the library is built with METALL_NODE_STORAGE_DEBUG_VIEWS. Memory grows with the number of distinct views.
+ */
+class ViewChecker {
+    char const *mapping_begin_;
+    char const *mapping_end_;
+    mutable std::mutex mutex_;
+    /**
+     * Start address -> length and hash of the bytes when they were handed out.
+     */
+    std::unordered_map<char const *, std::pair<size_t, uint64_t>> views_;
+
+public:
+    ViewChecker(void const *mapping, size_t mapping_size) noexcept
+        : mapping_begin_(static_cast<char const *>(mapping)), mapping_end_(mapping_begin_ + mapping_size) {}
+
+    /**
+     * @param in_mapping true if str must point into the mapped datastore
+     * @throws std::logic_error if str violates the contract
+     */
+    void record(std::string_view str, bool in_mapping) {
+        if (str.empty())
+            return;
+        if (in_mapping && mapping_begin_ != mapping_end_ && (str.data() < mapping_begin_ || str.data() + str.size() > mapping_end_))
+            throw std::logic_error("View does not point into the mapped datastore.");
+
+        uint64_t const hash = ViewHash::hash_bytes(str);
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto const [it, inserted] = views_.try_emplace(str.data(), str.size(), hash);
+        if (!inserted && it->second.first == str.size() && it->second.second != hash)
+            throw std::logic_error("Bytes behind a view that was handed out have changed.");
+    }
+
+    /**
+     * Rechecks all views recorded so far.
+     * @return number of views checked
+     * @throws std::logic_error if the bytes behind any of them have changed
+     */
+    size_t verify() const {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto const &[data, entry] : views_) {
+            if (ViewHash::hash_bytes(std::string_view{data, entry.first}) != entry.second)
+                throw std::logic_error("Bytes behind a view that was handed out have changed.");
+        }
+        return views_.size();
+    }
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_VIEWCHECKER_HPP
@@ -0,0 +1,69 @@
+#include "ViewHash.hpp"
+
+#include <cstring>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+namespace {
+constexpr uint64_t murmur_m = 0xc6a4a7935bd1e995ULL;
+constexpr int murmur_r = 47;
+
+inline uint64_t load_u64(char const *p) noexcept {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+}  // namespace
+
+uint64_t ViewHash::hash_bytes(std::string_view bytes, uint64_t seed) noexcept {
+    // MurmurHash64A, reading the input as little-endian words
+    uint64_t h = seed ^ (bytes.size() * murmur_m);
+
+    char const *data = bytes.data();
+    char const *const end = data + (bytes.size() & ~size_t{7});
+    for (; data != end; data += 8) {
+        uint64_t k = load_u64(data);
+        k *= murmur_m;
+        k ^= k >> murmur_r;
+        k *= murmur_m;
+
+        h ^= k;
+        h *= murmur_m;
+    }
+
+    auto const tail = reinterpret_cast<unsigned char const *>(data);
+    switch (bytes.size() & 7) {
+        case 7: h ^= uint64_t(tail[6]) << 48; [[fallthrough]];
+        case 6: h ^= uint64_t(tail[5]) << 40; [[fallthrough]];
+        case 5: h ^= uint64_t(tail[4]) << 32; [[fallthrough]];
+        case 4: h ^= uint64_t(tail[3]) << 24; [[fallthrough]];
+        case 3: h ^= uint64_t(tail[2]) << 16; [[fallthrough]];
+        case 2: h ^= uint64_t(tail[1]) << 8; [[fallthrough]];
+        case 1:
+            h ^= uint64_t(tail[0]);
+            h *= murmur_m;
+            break;
+        default:
+            break;
+    }
+
+    h ^= h >> murmur_r;
+    h *= murmur_m;
+    h ^= h >> murmur_r;
+    return h;
+}
+
+uint64_t ViewHash::operator()(view::IRIBackendView const &view) const noexcept {
+    return hash_bytes(view.identifier);
+}
+uint64_t ViewHash::operator()(view::LiteralBackendView const &view) const noexcept {
+    uint64_t h = hash_bytes(view.lexical_form, view.datatype_id.value());
+    return hash_bytes(view.language_tag, h);
+}
+uint64_t ViewHash::operator()(view::BNodeBackendView const &view) const noexcept {
+    return hash_bytes(view.identifier);
+}
+uint64_t ViewHash::operator()(view::VariableBackendView const &view) const noexcept {
+    return hash_bytes(view.name, view.is_anonymous ? 1 : 0);
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
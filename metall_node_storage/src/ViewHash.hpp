@@ -0,0 +1,29 @@
+#ifndef METALL_VIEWHASH_HPP
+#define METALL_VIEWHASH_HPP
+
+#include <rdf4cpp/rdf/storage/node/view/BNodeBackendView.hpp>
+#include <rdf4cpp/rdf/storage/node/view/IRIBackendView.hpp>
+#include <rdf4cpp/rdf/storage/node/view/LiteralBackendView.hpp>
+#include <rdf4cpp/rdf/storage/node/view/VariableBackendView.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * 64-bit hash over the payload of a backend view.
+ * The values are persisted in the datastore, so the function must produce the same result across builds and platforms.
+ * std::hash gives no such guarantee.
+ */
+struct ViewHash {
+    [[nodiscard]] static uint64_t hash_bytes(std::string_view bytes, uint64_t seed = 0) noexcept;
+
+    [[nodiscard]] uint64_t operator()(view::IRIBackendView const &view) const noexcept;
+    [[nodiscard]] uint64_t operator()(view::LiteralBackendView const &view) const noexcept;
+    [[nodiscard]] uint64_t operator()(view::BNodeBackendView const &view) const noexcept;
+    [[nodiscard]] uint64_t operator()(view::VariableBackendView const &view) const noexcept;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_VIEWHASH_HPP
@@ -0,0 +1,62 @@
+#include "WarmUp.hpp"
+
+#include "MappingOptions.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+WarmUp::WarmUp(std::vector<WarmUpRegion> const &regions, WarmUpOptions options)
+    : progress_(std::move(options.progress)) {
+    std::vector<WarmUpRegion> ordered = regions;
+    std::stable_sort(ordered.begin(), ordered.end(), [](WarmUpRegion const &a, WarmUpRegion const &b) {
+        return a.phase < b.phase;
+    });
+
+    for (auto const &region : ordered) {
+        auto const *const address = static_cast<char const *>(region.address);
+        for (size_t offset = 0; offset < region.size && bytes_total_ < options.memory_budget; offset += piece_size) {
+            size_t const size = static_cast<size_t>(std::min<uint64_t>({piece_size, region.size - offset, options.memory_budget - bytes_total_}));
+            pieces_.push_back(Piece{.address = address + offset, .size = size, .phase = region.phase});
+            bytes_total_ += size;
+        }
+    }
+
+    unsigned thread_count = options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    thread_count = static_cast<unsigned>(std::min<size_t>(thread_count, pieces_.size()));
+    running_ = thread_count;
+    threads_.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i)
+        threads_.emplace_back([this](std::stop_token stop) { run(stop); });
+}
+
+void WarmUp::run(std::stop_token const &stop) {
+    while (!stop.stop_requested()) {
+        size_t const next = next_piece_.fetch_add(1, std::memory_order_relaxed);
+        if (next >= pieces_.size())
+            break;
+
+        Piece const &piece = pieces_[next];
+        if (!populate(piece.address, piece.size))
+            ok_.store(false, std::memory_order_relaxed);
+        bytes_loaded_.fetch_add(piece.size, std::memory_order_relaxed);
+        if (progress_) {
+            std::lock_guard<std::mutex> lock{progress_mutex_};
+            progress_(WarmUpProgress{.phase = piece.phase, .bytes_loaded = bytes_loaded(), .bytes_total = bytes_total_});
+        }
+    }
+    if (running_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        running_.notify_all();
+}
+
+void WarmUp::wait() const noexcept {
+    for (unsigned running = running_.load(std::memory_order_acquire); running != 0; running = running_.load(std::memory_order_acquire))
+        running_.wait(running, std::memory_order_acquire);
+}
+
+void WarmUp::cancel() noexcept {
+    for (auto &thread : threads_)
+        thread.request_stop();
+}
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
\ No newline at end of file
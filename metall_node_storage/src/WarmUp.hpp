@@ -0,0 +1,142 @@
+#ifndef METALL_WARMUP_HPP
+#define METALL_WARMUP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace rdf4cpp::rdf::storage::node::metall_node_storage {
+
+/**
+ * Parts of a datastore in the order in which WarmUp loads them.
+ */
+enum struct WarmUpPhase {
+    /**
+     * Reverse indexes, every lookup by value probes them at a random position.
+     */
+    index,
+    /**
+     * Forward tables, every lookup by id reads them.
+     */
+    forward,
+    /**
+     * Strings of the nodes.
+     */
+    strings,
+};
+
+struct WarmUpRegion {
+    void const *address;
+    size_t size;
+    WarmUpPhase phase;
+};
+
+struct WarmUpProgress {
+    /**
+     * Phase of the region that was just loaded.
+     */
+    WarmUpPhase phase;
+    uint64_t bytes_loaded;
+    uint64_t bytes_total;
+};
+
+struct WarmUpOptions {
+    /**
+     * Loading stops after this many bytes. Regions of earlier phases are loaded first.
+     */
+    uint64_t memory_budget = std::numeric_limits<uint64_t>::max();
+    /**
+     * Number of loading threads, 0 for one per hardware thread.
+     */
+    unsigned threads = 0;
+    /**
+     * Called after every loaded piece of at most piece_size bytes. Calls are serialized, but come from the loading threads. Must not throw.
+     */
+    std::function<void(WarmUpProgress const &)> progress;
+};
+
+/**
+ * Loads regions of a mapped datastore into memory in the background, see MetallNodeStorageBackend::warm_up.
+ * The regions are cut into pieces which the threads take in order, so the pieces of a phase are requested
+ * before those of the next one. Each piece is read with populate.
+ * The destructor cancels the loading and waits for the threads.
+ */
+class WarmUp {
+public:
+    static constexpr size_t piece_size = size_t{16} << 20;
+
+private:
+    struct Piece {
+        char const *address;
+        size_t size;
+        WarmUpPhase phase;
+    };
+
+    std::vector<Piece> pieces_;
+    uint64_t bytes_total_ = 0;
+    std::function<void(WarmUpProgress const &)> progress_;
+    std::mutex progress_mutex_;
+    std::atomic<size_t> next_piece_ = 0;
+    std::atomic<uint64_t> bytes_loaded_ = 0;
+    std::atomic<unsigned> running_ = 0;
+    std::atomic<bool> ok_ = true;
+    /**
+     * Last member, the threads start once everything else is initialized.
+     */
+    std::vector<std::jthread> threads_;
+
+    void run(std::stop_token const &stop);
+
+public:
+    /**
+     * Starts loading regions, truncated to options.memory_budget.
+     * The regions must stay mapped until the WarmUp is done or destroyed.
+     */
+    WarmUp(std::vector<WarmUpRegion> const &regions, WarmUpOptions options);
+
+    ~WarmUp() = default;
+
+    WarmUp(WarmUp const &) = delete;
+    WarmUp &operator=(WarmUp const &) = delete;
+
+    [[nodiscard]] uint64_t bytes_loaded() const noexcept {
+        return bytes_loaded_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Bytes that will be loaded if the WarmUp is not canceled.
+     */
+    [[nodiscard]] uint64_t bytes_total() const noexcept {
+        return bytes_total_;
+    }
+
+    [[nodiscard]] bool done() const noexcept {
+        return running_.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * @return false if the kernel rejected the read-ahead for any piece, see populate
+     */
+    [[nodiscard]] bool ok() const noexcept {
+        return ok_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Blocks until all threads have finished. Thread-safe.
+     */
+    void wait() const noexcept;
+
+    /**
+     * Stops the threads after their current piece. Does not wait for them.
+     */
+    void cancel() noexcept;
+};
+
+}  // namespace rdf4cpp::rdf::storage::node::metall_node_storage
+#endif  //METALL_WARMUP_HPP